@@ -0,0 +1,73 @@
+#!/usr/bin/python
+
+# This is a load test for the event server. It simulates a number of
+# clients that each greet XBMC and then keep sending button presses,
+# so you can check how responsive XBMC stays with many remotes.
+
+# Every simulated client uses its own socket and unique identification,
+# which is what XBMC uses to tell clients apart.
+
+# Keep in mind that XBMC only accepts as many clients as configured in
+# the event server settings ("Maximum number of clients").
+
+# usage: example_loadtest.py [clients] [seconds] [presses per second per client] [host] [port]
+
+import sys
+sys.path.append("../../lib/python")
+
+from xbmcclient import *
+from socket import *
+
+def main():
+    import time
+    import random
+
+    clients = 100
+    duration = 30
+    rate = 2.0
+    host = "localhost"
+    port = 9777
+
+    if len(sys.argv) > 1: clients = int(sys.argv[1])
+    if len(sys.argv) > 2: duration = int(sys.argv[2])
+    if len(sys.argv) > 3: rate = float(sys.argv[3])
+    if len(sys.argv) > 4: host = sys.argv[4]
+    if len(sys.argv) > 5: port = int(sys.argv[5])
+
+    addr = (host, port)
+    uid = int(time.time())
+
+    # greet XBMC from every client, without an icon to keep the packets small
+    socks = []
+    for i in range(clients):
+        sock = socket(AF_INET,SOCK_DGRAM)
+        PacketHELO(devicename="Load Test %d" % i).send(sock, addr, uid + i)
+        socks.append(sock)
+
+    # up and down are harmless in almost every window
+    buttons = [ "up", "down" ]
+    interval = 1.0 / (rate * clients)
+    sent = 0
+    start = time.time()
+    next = start
+
+    print "sending %.1f presses per second from %d clients for %d seconds" % (rate * clients, clients, duration)
+    while time.time() - start < duration:
+        i = random.randint(0, clients - 1)
+        packet = PacketBUTTON(map_name="R1", button_name=random.choice(buttons), queue=1)
+        packet.send(socks[i], addr, uid + i)
+        sent += 1
+
+        next += interval
+        delay = next - time.time()
+        if delay > 0:
+            time.sleep(delay)
+
+    elapsed = time.time() - start
+    print "sent %d presses in %.1f seconds (%.1f per second)" % (sent, elapsed, sent / elapsed)
+
+    for i in range(clients):
+        PacketBYE().send(socks[i], addr, uid + i)
+
+if __name__=="__main__":
+    main()
@@ -22,13 +22,52 @@
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 
+#include <map>
+#include <typeinfo>
+
 using namespace std;
 
 #define ITEMS_PER_THREAD 5
+// items a job loads before it makes way for the other jobs of the pool
+#define ITEMS_PER_JOB 10
+
+class CBackgroundLoaderJob : public CJob
+{
+public:
+  CBackgroundLoaderJob(CBackgroundInfoLoader *loader) : m_loader(loader), m_done(false) {}
+  virtual ~CBackgroundLoaderJob()
+  {
+    // a job that was cancelled before it got to run still has to be accounted for
+    if (!m_done)
+      m_loader->OnJobDone();
+  }
+
+  virtual const char *GetType() const { return "backgroundinfoloader"; }
+  virtual bool DoWork()
+  {
+    // continue in a new job at the end of the queue, so that other low priority jobs get their turn
+    if (m_loader->LoadItems(ITEMS_PER_JOB))
+      m_loader->QueueJob();
+    m_done = true;
+    m_loader->OnJobDone();
+    return true;
+  }
+
+private:
+  CBackgroundInfoLoader *m_loader;
+  bool m_done;
+};
+
+// paths (prefixed by the loader type) that are currently being loaded by any loader
+static CCriticalSection g_loadingSection;
+static map<string, int> g_loading;
 
 CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
+  : m_jobsDone(true, true)
 {
   m_bStop = true;
   m_pObserver=NULL;
@@ -37,6 +76,8 @@ CBackgroundInfoLoader::CBackgroundInfoLoader(int nThreads)
   m_nRequestedThreads = nThreads;
   m_bStartCalled = false;
   m_nActiveThreads = 0;
+  m_focus = m_next = 0;
+  m_prev = -1;
 }
 
 CBackgroundInfoLoader::~CBackgroundInfoLoader()
@@ -51,61 +92,125 @@ void CBackgroundInfoLoader::SetNumOfWorkers(int nThreads)
 
 void CBackgroundInfoLoader::Run()
 {
+  LoadItems(0);
+}
+
+bool CBackgroundInfoLoader::LoadItems(unsigned int count)
+{
+  unsigned int loaded = 0;
   try
   {
-    if (m_vecItems.size() > 0)
     {
+      CSingleLock lock(m_lock);
+      if (!m_bStartCalled && !m_vecItems.empty())
       {
-        CSingleLock lock(m_lock);
-        if (!m_bStartCalled)
-        {
-          OnLoaderStart();
-          m_bStartCalled = true;
-        }
+        OnLoaderStart();
+        m_bStartCalled = true;
       }
+    }
 
-      while (!m_bStop)
+    while (!m_bStop)
+    {
+      if (count > 0 && loaded >= count)
+        return true;
+
+      // Ask the callback if we should abort
+      if (m_pProgressCallback && m_pProgressCallback->Abort())
+        break;
+
+      string key;
+      CFileItemPtr pItem;
       {
         CSingleLock lock(m_lock);
-        CFileItemPtr pItem;
-        vector<CFileItemPtr>::iterator iter = m_vecItems.begin();
-        if (iter != m_vecItems.end())
-        {
-          pItem = *iter;
-          m_vecItems.erase(iter);
-        }
-
-        if (pItem == NULL)
-          break;
-
-        // Ask the callback if we should abort
-        if ((m_pProgressCallback && m_pProgressCallback->Abort()) || m_bStop)
-          break;
-
-        lock.Leave();
-        try
-        {
-          if (LoadItem(pItem.get()) && m_pObserver)
-            m_pObserver->OnItemLoaded(pItem.get());
-        }
-        catch (...)
-        {
-          CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
-        }
+        pItem = GetNextItem(key);
       }
-    }
 
-    CSingleLock lock(m_lock);
-    if (m_nActiveThreads == 1)
-      OnLoaderFinish();
-    m_nActiveThreads--;
+      if (pItem == NULL)
+        break;
 
+      try
+      {
+        if (LoadItem(pItem.get()) && m_pObserver)
+          m_pObserver->OnItemLoaded(pItem.get());
+      }
+      catch (...)
+      {
+        CLog::Log(LOGERROR, "%s::LoadItem - Unhandled exception for item %s", __FUNCTION__, pItem->GetPath().c_str());
+      }
+      EndLoading(key);
+      loaded++;
+    }
   }
   catch (...)
   {
-    m_nActiveThreads--;
     CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
   }
+  return false;
+}
+
+CFileItemPtr CBackgroundInfoLoader::GetNextItem(string &key)
+{
+  const int size = (int)m_vecItems.size();
+  while (true)
+  {
+    while (m_next < size && m_taken[m_next])
+      m_next++;
+    while (m_prev >= 0 && m_taken[m_prev])
+      m_prev--;
+
+    // two items after the focused one for each one before it, as the
+    // focused item usually is near the top of what is on screen
+    int item;
+    bool force = false;
+    if (m_next < size && (m_prev < 0 || m_next - m_focus <= 2 * (m_focus - m_prev)))
+      item = m_next++;
+    else if (m_prev >= 0)
+      item = m_prev--;
+    else if (!m_deferred.empty())
+    {
+      // whoever was busy with these is likely done by now
+      item = m_deferred.front();
+      m_deferred.pop_front();
+      force = true;
+    }
+    else
+      return CFileItemPtr();
+
+    m_taken[item] = true;
+    const CFileItemPtr &pItem = m_vecItems[item];
+    key = pItem->GetPath().empty() ? "" : string(typeid(*this).name()) + "|" + pItem->GetPath();
+    if (BeginLoading(key, force))
+      return pItem;
+
+    m_deferred.push_back(item);
+  }
+}
+
+bool CBackgroundInfoLoader::BeginLoading(const string &key, bool force)
+{
+  if (key.empty())
+    return true;
+
+  CSingleLock lock(g_loadingSection);
+  map<string, int>::iterator it = g_loading.find(key);
+  if (it == g_loading.end())
+    g_loading.insert(make_pair(key, 1));
+  else if (force)
+    it->second++;
+  else
+    return false;
+  return true;
+}
+
+void CBackgroundInfoLoader::EndLoading(const string &key)
+{
+  if (key.empty())
+    return;
+
+  CSingleLock lock(g_loadingSection);
+  map<string, int>::iterator it = g_loading.find(key);
+  if (it != g_loading.end() && --it->second <= 0)
+    g_loading.erase(it);
 }
 
 void CBackgroundInfoLoader::Load(CFileItemList& items)
@@ -119,6 +224,10 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
 
   for (int nItem=0; nItem < items.Size(); nItem++)
     m_vecItems.push_back(items[nItem]);
+  m_taken.assign(m_vecItems.size(), false);
+  m_deferred.clear();
+  m_focus = m_next = 0;
+  m_prev = -1;
 
   m_pVecItems = &items;
   m_bStop = false;
@@ -131,17 +240,74 @@ void CBackgroundInfoLoader::Load(CFileItemList& items)
   if (nThreads > g_advancedSettings.m_bgInfoLoaderMaxThreads)
     nThreads = g_advancedSettings.m_bgInfoLoaderMaxThreads;
 
+  // leave at least one low priority worker to the other jobs (texture caching, thumb extraction)
+  int maxJobs = (int)CJobManager::GetInstance().GetMaxWorkers(CJob::PRIORITY_LOW) - 1;
+  if (nThreads > maxJobs)
+    nThreads = std::max(maxJobs, 1);
+
   m_nActiveThreads = nThreads;
+  m_jobsDone.Reset();
+  lock.Leave();
+
+  // jobs may start (and finish) right away, so don't hold the lock while adding them.
+  // Each job only loads a few items and then queues its successor behind the other
+  // low priority jobs, so a long list doesn't keep them from running until it's done.
+  vector<unsigned int> jobs;
   for (int i=0; i < nThreads; i++)
+    jobs.push_back(CJobManager::GetInstance().AddJob(new CBackgroundLoaderJob(this), NULL, CJob::PRIORITY_LOW));
+
+  lock.Enter();
+  m_jobs.insert(m_jobs.end(), jobs.begin(), jobs.end());
+}
+
+void CBackgroundInfoLoader::PrioritizeItem(const CFileItemPtr &item)
+{
+  CSingleLock lock(m_lock);
+  for (int i = 0; i < (int)m_vecItems.size(); i++)
+  {
+    if (m_vecItems[i] == item)
+    {
+      m_focus = m_next = i;
+      m_prev = i - 1;
+      break;
+    }
+  }
+}
+
+void CBackgroundInfoLoader::QueueJob()
+{
   {
-    CThread *pThread = new CThread(this, "Background Loader");
-    pThread->Create();
-#ifndef _LINUX
-    pThread->SetPriority(THREAD_PRIORITY_BELOW_NORMAL);
-#endif
-    m_workers.push_back(pThread);
+    CSingleLock lock(m_lock);
+    m_nActiveThreads++;
   }
 
+  CBackgroundLoaderJob *job = new CBackgroundLoaderJob(this);
+  unsigned int id = CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_LOW);
+  if (id == 0)
+  { // the job accounts for itself when it's destroyed
+    delete job;
+    return;
+  }
+
+  CSingleLock lock(m_lock);
+  m_jobs.push_back(id);
+}
+
+void CBackgroundInfoLoader::OnJobDone()
+{
+  // the last job to finish (or to be dropped before it ran) closes the loader.
+  // Counting and closing happen under one lock, so exactly one job does it.
+  CSingleLock lock(m_lock);
+  if (--m_nActiveThreads <= 0)
+  {
+    m_nActiveThreads = 0;
+    if (m_bStartCalled)
+    {
+      OnLoaderFinish();
+      m_bStartCalled = false;
+    }
+    m_jobsDone.Set();
+  }
 }
 
 void CBackgroundInfoLoader::StopAsync()
@@ -154,18 +320,29 @@ void CBackgroundInfoLoader::StopThread()
 {
   StopAsync();
 
-  for (int i=0; i<(int)m_workers.size(); i++)
+  vector<unsigned int> jobs;
   {
-    m_workers[i]->StopThread();
-    delete m_workers[i];
+    CSingleLock lock(m_lock);
+    jobs.swap(m_jobs);
   }
 
-  m_workers.clear();
+  // jobs that haven't started yet are dropped, the running ones stop after their current item
+  for (vector<unsigned int>::const_iterator it = jobs.begin(); it != jobs.end(); ++it)
+    CJobManager::GetInstance().CancelJob(*it);
+  m_jobsDone.Wait();
+
+  CSingleLock lock(m_lock);
+  if (m_bStartCalled)
+  {
+    OnLoaderFinish();
+    m_bStartCalled = false;
+  }
   m_vecItems.clear();
+  m_taken.clear();
+  m_deferred.clear();
   m_pVecItems = NULL;
   m_nActiveThreads = 0;
 }
-
 bool CBackgroundInfoLoader::IsLoading()
 {
   return m_nActiveThreads > 0;
@@ -23,7 +23,10 @@
 #include "threads/Thread.h"
 #include "IProgressCallback.h"
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 
+#include <deque>
+#include <string>
 #include <vector>
 #include "boost/shared_ptr.hpp"
 
@@ -37,6 +40,16 @@ public:
   virtual void OnItemLoaded(CFileItem* pItem) = 0;
 };
 
+/*!
+ \brief Loads additional information for the items of a list in the background.
+
+ The work is done by low priority jobs on the shared CJobManager pool. Each job
+ loads a few items and then queues its successor, so the loader shares the pool
+ with the other low priority jobs. Items are handed out starting at the item
+ given to PrioritizeItem() (the first one by default) so that the items on
+ screen are loaded first. An item that is being loaded by another loader of the
+ same type is put off until the end of the list.
+ */
 class CBackgroundInfoLoader : public IRunnable
 {
 public:
@@ -50,6 +63,11 @@ public:
   void SetProgressCallback(IProgressCallback* pCallback);
   virtual bool LoadItem(CFileItem* pItem) { return false; };
 
+  /*! \brief Load the items around the given item next.
+   \param item the item to continue loading at, usually the selected one.
+   */
+  void PrioritizeItem(const CFileItemPtr &item);
+
   void StopThread(); // will actually stop all worker threads.
   void StopAsync();  // will ask loader to stop as soon as possible, but not block
 
@@ -71,6 +89,28 @@ protected:
   IBackgroundLoaderObserver* m_pObserver;
   IProgressCallback* m_pProgressCallback;
 
-  std::vector<CThread *> m_workers;
-};
+private:
+  friend class CBackgroundLoaderJob;
+
+  CFileItemPtr GetNextItem(std::string &key);
+  void OnJobDone();
+  void QueueJob();
 
+  /*! \brief Load the next items of the list.
+   \param count the number of items to load, 0 to load all that are left.
+   \return true if items are left to load, false once the list is done or loading was stopped.
+   */
+  bool LoadItems(unsigned int count);
+
+  static bool BeginLoading(const std::string &key, bool force);
+  static void EndLoading(const std::string &key);
+
+  std::vector<bool> m_taken;  ///< items that have been handed out to a worker
+  std::deque<int> m_deferred; ///< items that were busy in another loader
+  int m_focus;                ///< item to load around
+  int m_next;                 ///< next candidate at or after m_focus
+  int m_prev;                 ///< next candidate before m_focus
+
+  std::vector<unsigned int> m_jobs;
+  CEvent m_jobsDone;
+};
@@ -330,13 +330,16 @@ CStdString CScraper::InternalRun(const CStdString& function,
                                  CCurlFile& http,
                                  const vector<CStdString>* extras)
 {
-  // walk the list of input URLs and fetch each into parser parameters
+  // fetch the list of input URLs into parser parameters
+  vector<string> strHTMLs;
+  if (!CScraperUrl::Get(scrURL.m_url,strHTMLs,http,ID()))
+    return "";
   unsigned int i;
-  for (i=0;i<scrURL.m_url.size();++i)
+  for (i=0;i<strHTMLs.size();++i)
   {
-    CStdString strCurrHTML;
-    if (!CScraperUrl::Get(scrURL.m_url[i],m_parser.m_param[i],http,ID()) || m_parser.m_param[i].size() == 0)
+    if (strHTMLs[i].size() == 0)
       return "";
+    m_parser.m_param[i] = strHTMLs[i];
   }
   // put the 'extra' parameterts into the parser parameter list too
   if (extras)
@@ -297,6 +297,13 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   {
     if(changes == 0)
       return o->m_overlay->Acquire();
+
+#if defined(HAS_GL) || defined(HAS_GLES)
+    // only positions or colors changed (moving or karaoke text), keep the texture
+    COverlayGlyphGL* glyph = dynamic_cast<COverlayGlyphGL*>(o->m_overlay);
+    if(changes == 1 && glyph && glyph->UpdatePositions(images, width, height))
+      return o->m_overlay->Acquire();
+#endif
   }
 
 #if defined(HAS_GL) || defined(HAS_GLES)
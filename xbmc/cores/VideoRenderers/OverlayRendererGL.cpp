@@ -263,6 +263,9 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
 COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
 {
   m_vertex = NULL;
+  m_count  = 0;
+  m_size_x = 0;
+  m_size_y = 0;
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
@@ -289,14 +292,45 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
             , quads.data);
 
 
+  m_size_x = quads.size_x;
+  m_size_y = quads.size_y;
+  BuildVertices(quads, width, height);
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+}
+
+bool COverlayGlyphGL::UpdatePositions(ASS_Image* images, int width, int height)
+{
+  if(m_texture == 0)
+    return false;
+
+  SQuads quads;
+  if(!convert_quad(images, quads, false))
+    return false;
+
+  // glyphs may have become (in)visible, which changes the texture layout
+  if(quads.count != m_count || quads.size_x != m_size_x || quads.size_y != m_size_y)
+    return false;
+
+  BuildVertices(quads, width, height);
+  return true;
+}
+
+void COverlayGlyphGL::BuildVertices(SQuads& quads, int width, int height)
+{
   float scale_u = m_u / quads.size_x;
   float scale_v = m_v / quads.size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
 
-  m_count  = quads.count;
-  m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
+  if(m_count != quads.count || !m_vertex)
+  {
+    free(m_vertex);
+    m_count  = quads.count;
+    m_vertex = (VERTEX*)calloc(m_count * 4, sizeof(VERTEX));
+  }
 
   VERTEX* vt = m_vertex;
   SQuad*  vs = quads.quad;
@@ -361,9 +395,6 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
     vs += 1;
     vt += 4;
   }
-
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
 }
 
 COverlayGlyphGL::~COverlayGlyphGL()
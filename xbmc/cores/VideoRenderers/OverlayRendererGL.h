@@ -23,6 +23,7 @@
 #pragma once
 #include "system_gl.h"
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -60,6 +61,14 @@ namespace OVERLAY {
 
    void Render(SRenderState& state);
 
+   /*! \brief update glyph positions and colors, keeping the uploaded texture
+    Only valid when libass reports that the bitmaps themselves didn't change.
+    \return false if the images don't fit the existing texture
+    */
+   bool UpdatePositions(ASS_Image* images, int width, int height);
+
+   void BuildVertices(SQuads& quads, int width, int height);
+
     struct VERTEX
     {
        GLfloat u, v;
@@ -73,6 +82,8 @@ namespace OVERLAY {
    GLuint m_texture;
    float  m_u;
    float  m_v;
+   int    m_size_x;
+   int    m_size_y;
   };
 
 }
@@ -180,7 +180,10 @@ uint32_t* convert_rgba(CDVDOverlaySpu* o, bool mergealpha
   return rgba;
 }
 
-bool convert_quad(ASS_Image* images, SQuads& quads)
+/* packs the glyphs of images into a single alpha texture. if bitmaps is false
+ * only the placement of the glyphs is calculated and no texture data is
+ * allocated, which is enough when only positions or colors changed */
+bool convert_quad(ASS_Image* images, SQuads& quads, bool bitmaps)
 {
   ASS_Image* img;
 
@@ -234,7 +237,8 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
   // allocate space for the glyph positions and texturedata
 
   quads.quad = (SQuad*)  calloc(quads.count, sizeof(SQuad));
-  quads.data = (uint8_t*)calloc(quads.size_x * quads.size_y, 1);
+  if (bitmaps)
+    quads.data = (uint8_t*)calloc(quads.size_x * quads.size_y, 1);
 
   SQuad*   v    = quads.quad;
   uint8_t* data = quads.data;
@@ -257,7 +261,8 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
       curr_y += y + 1;
       curr_x  = 0;
       y       = 0;
-      data    = quads.data + curr_y * quads.size_x;
+      if (bitmaps)
+        data  = quads.data + curr_y * quads.size_x;
     }
 
     unsigned int r = ((color >> 24) & 0xff);
@@ -280,16 +285,19 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
 
     v++;
 
-    for(int i=0; i<img->h; i++)
-      memcpy(data        + quads.size_x * i
-           , img->bitmap + img->stride  * i
-           , img->w);
+    if (bitmaps)
+    {
+      for(int i=0; i<img->h; i++)
+        memcpy(data        + quads.size_x * i
+             , img->bitmap + img->stride  * i
+             , img->w);
+      data += img->w + 1;
+    }
 
     if (img->h > y)
       y = img->h;
 
     curr_x += img->w + 1;
-    data   += img->w + 1;
   }
   return true;
 }
@@ -47,6 +47,8 @@
 #include "threads/SystemClock.h"
 #include "utils/TimeUtils.h"
 
+#include <list>
+
 void CDemuxStreamAudioFFmpeg::GetStreamInfo(std::string& strInfo)
 {
   if(!m_stream) return;
@@ -203,6 +205,87 @@ static offset_t dvd_file_seek(void *h, offset_t pos, int whence)
 ////////////////////////////////////////////////////////////////////////////////////////////////
 ////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define SEEKINDEX_CACHE_FILES 16
+
+typedef std::list<std::pair<std::string, CDVDDemuxSeekIndex> > SeekIndexCache;
+static SeekIndexCache   g_seekIndexCache;
+static CCriticalSection g_seekIndexSection;
+
+void CDVDDemuxSeekIndex::AddKeyframe(int time, int64_t pos)
+{
+  if (time < 0 || pos < 0)
+    return;
+
+  // we're contiguous with the last keyframe read if nothing else is
+  // indexed between the two
+  bool contiguous = false;
+  Entries::iterator it = m_entries.lower_bound(time);
+  if (m_lastTime >= 0 && it != m_entries.begin())
+  {
+    Entries::iterator prev = it;
+    --prev;
+    contiguous = prev->first == m_lastTime;
+  }
+
+  if (it != m_entries.end() && it->first == time)
+    it->second.contiguous |= contiguous;
+  else
+  {
+    Entry entry = { pos, contiguous };
+    m_entries.insert(it, std::make_pair(time, entry));
+  }
+  m_lastTime = time;
+}
+
+bool CDVDDemuxSeekIndex::Lookup(int time, bool backwards, int64_t &pos) const
+{
+  Entries::const_iterator next = m_entries.upper_bound(time);
+  if (next == m_entries.end() || next == m_entries.begin() || !next->second.contiguous)
+    return false;
+
+  Entries::const_iterator prev = next;
+  --prev;
+  if (prev->first == time || backwards)
+    pos = prev->second.pos;
+  else
+    pos = next->second.pos;
+  return true;
+}
+
+void CDVDDemuxSeekIndex::Store(const std::string &file, const CDVDDemuxSeekIndex &index)
+{
+  if (file.empty() || index.IsEmpty())
+    return;
+
+  CSingleLock lock(g_seekIndexSection);
+  for (SeekIndexCache::iterator it = g_seekIndexCache.begin(); it != g_seekIndexCache.end(); ++it)
+  {
+    if (it->first == file)
+    {
+      g_seekIndexCache.erase(it);
+      break;
+    }
+  }
+  g_seekIndexCache.push_front(std::make_pair(file, index));
+  g_seekIndexCache.front().second.Discontinuity();
+  if (g_seekIndexCache.size() > SEEKINDEX_CACHE_FILES)
+    g_seekIndexCache.pop_back();
+}
+
+bool CDVDDemuxSeekIndex::Restore(const std::string &file, CDVDDemuxSeekIndex &index)
+{
+  CSingleLock lock(g_seekIndexSection);
+  for (SeekIndexCache::iterator it = g_seekIndexCache.begin(); it != g_seekIndexCache.end(); ++it)
+  {
+    if (it->first == file)
+    {
+      index = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
 CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
 {
   m_pFormatContext = NULL;
@@ -214,6 +297,7 @@ CDVDDemuxFFmpeg::CDVDDemuxFFmpeg() : CDVDDemux()
   m_bAVI = false;
   m_speed = DVD_PLAYSPEED_NORMAL;
   m_program = UINT_MAX;
+  m_useSeekIndex = false;
 }
 
 CDVDDemuxFFmpeg::~CDVDDemuxFFmpeg()
@@ -434,6 +518,17 @@ bool CDVDDemuxFFmpeg::Open(CDVDInputStream* pInput)
   m_bMatroska = strncmp(m_pFormatContext->iformat->name, "matroska", 8) == 0;	// for "matroska.webm"
   m_bAVI = strcmp(m_pFormatContext->iformat->name, "avi") == 0;
 
+  // mpeg ts/ps have no index, so ffmpeg seeks by bisecting the file which
+  // is slow over the network. keep our own keyframe index for those.
+  m_useSeekIndex = m_pInput->IsStreamType(DVDSTREAM_TYPE_FILE)
+                && !(m_pFormatContext->iformat->flags & AVFMT_NO_BYTE_SEEK)
+                && (strcmp(m_pFormatContext->iformat->name, "mpegts") == 0
+                 || strcmp(m_pFormatContext->iformat->name, "mpeg") == 0);
+  m_seekIndex = CDVDDemuxSeekIndex();
+  m_seekIndexFile = m_useSeekIndex ? m_pInput->GetFileName() : "";
+  if (m_useSeekIndex && CDVDDemuxSeekIndex::Restore(m_seekIndexFile, m_seekIndex))
+    CLog::Log(LOGDEBUG, "%s - using cached seek index with %u keyframes", __FUNCTION__, (unsigned int)m_seekIndex.Size());
+
   if (streaminfo)
   {
     /* too speed up dvd switches, only analyse very short */
@@ -504,6 +599,11 @@ void CDVDDemuxFFmpeg::Dispose()
 {
   g_demuxer.set(this);
 
+  if (m_useSeekIndex)
+    CDVDDemuxSeekIndex::Store(m_seekIndexFile, m_seekIndex);
+  m_seekIndex = CDVDDemuxSeekIndex();
+  m_useSeekIndex = false;
+
   if (m_pFormatContext)
   {
     if (m_ioContext && m_pFormatContext->pb && m_pFormatContext->pb != m_ioContext)
@@ -557,6 +657,7 @@ void CDVDDemuxFFmpeg::Flush()
     m_dllAvFormat.av_read_frame_flush(m_pFormatContext);
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
+  m_seekIndex.Discontinuity();
 }
 
 void CDVDDemuxFFmpeg::Abort()
@@ -766,6 +867,14 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
         }
 
         pPacket->iStreamId = pkt.stream_index; // XXX just for now
+
+        if (m_useSeekIndex && (pkt.flags & AV_PKT_FLAG_KEY) && pkt.pos >= 0
+        &&  stream->codec && stream->codec->codec_type == AVMEDIA_TYPE_VIDEO)
+        {
+          double ts = pPacket->dts != DVD_NOPTS_VALUE ? pPacket->dts : pPacket->pts;
+          if (ts != DVD_NOPTS_VALUE)
+            m_seekIndex.AddKeyframe(DVD_TIME_TO_MSEC(ts), pkt.pos);
+        }
       }
       m_dllAvCodec.av_free_packet(&pkt);
     }
@@ -847,7 +956,11 @@ bool CDVDDemuxFFmpeg::SeekTime(int time, bool backwords, double *startpts)
   int ret;
   {
     CSingleLock lock(m_critSection);
-    ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+    if (SeekIndexed(time, backwords))
+      ret = 0;
+    else
+      ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, seek_pts, backwords ? AVSEEK_FLAG_BACKWARD : 0);
+    m_seekIndex.Discontinuity();
 
     if(ret >= 0)
       UpdateCurrentPTS();
@@ -875,6 +988,7 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
 
   CSingleLock lock(m_critSection);
   int ret = m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE);
+  m_seekIndex.Discontinuity();
 
   if(ret >= 0)
     UpdateCurrentPTS();
@@ -882,6 +996,19 @@ bool CDVDDemuxFFmpeg::SeekByte(int64_t pos)
   return (ret >= 0);
 }
 
+bool CDVDDemuxFFmpeg::SeekIndexed(int time, bool backwords)
+{
+  int64_t pos;
+  if (!m_useSeekIndex || !m_seekIndex.Lookup(time, backwords, pos))
+    return false;
+
+  if (m_dllAvFormat.av_seek_frame(m_pFormatContext, -1, pos, AVSEEK_FLAG_BYTE) < 0)
+    return false;
+
+  CLog::Log(LOGDEBUG, "%s - seek to %dms using index, byte position %"PRId64, __FUNCTION__, time, pos);
+  return true;
+}
+
 void CDVDDemuxFFmpeg::UpdateCurrentPTS()
 {
   m_iCurrentPts = DVD_NOPTS_VALUE;
@@ -28,6 +28,8 @@
 #include "threads/CriticalSection.h"
 #include "threads/SystemClock.h"
 
+#include <map>
+
 class CDVDDemuxFFmpeg;
 
 class CDemuxStreamVideoFFmpeg
@@ -77,6 +79,53 @@ public:
 
 };
 
+/*!
+ \brief Keyframe index of a demuxed file, used to seek by byte offset.
+
+ Built from the keyframes seen while reading the file. Each entry remembers
+ whether it was read directly after the preceding entry, so a lookup only
+ succeeds when no unseen keyframe can lie between the entry found and the
+ requested time. Indexes survive the demuxer in a small process wide cache,
+ so reopening a file (resume, restart, chapter skips after a stop) reuses it.
+ */
+class CDVDDemuxSeekIndex
+{
+public:
+  CDVDDemuxSeekIndex() : m_lastTime(-1) {}
+
+  /*! \brief add a keyframe at the given time (ms) and byte position */
+  void AddKeyframe(int time, int64_t pos);
+
+  /*! \brief mark a discontinuity in reading, i.e. after a seek or flush */
+  void Discontinuity() { m_lastTime = -1; }
+
+  /*! \brief find the keyframe for a seek to the given time (ms)
+   \param time the time to seek to
+   \param backwards find the keyframe at or before time, otherwise at or after
+   \param pos [out] byte position of the keyframe
+   \return true if the index knows the exact keyframe for this time
+   */
+  bool Lookup(int time, bool backwards, int64_t &pos) const;
+
+  bool IsEmpty() const { return m_entries.empty(); }
+  size_t Size() const { return m_entries.size(); }
+
+  /*! \brief save an index in the process wide cache */
+  static void Store(const std::string &file, const CDVDDemuxSeekIndex &index);
+  /*! \brief fetch an index from the process wide cache */
+  static bool Restore(const std::string &file, CDVDDemuxSeekIndex &index);
+
+private:
+  struct Entry
+  {
+    int64_t pos;
+    bool    contiguous; ///< read directly after the previous entry
+  };
+  typedef std::map<int, Entry> Entries;
+  Entries m_entries;
+  int     m_lastTime;
+};
+
 #define FFMPEG_FILE_BUFFER_SIZE   32768 // default reading size for ffmpeg
 #define FFMPEG_DVDNAV_BUFFER_SIZE 2048  // for dvd's
 
@@ -122,6 +171,7 @@ protected:
 
   double ConvertTimestamp(int64_t pts, int den, int num);
   void UpdateCurrentPTS();
+  bool SeekIndexed(int time, bool backwords);
 
   CCriticalSection m_critSection;
   #define MAX_STREAMS 100
@@ -140,6 +190,10 @@ protected:
   unsigned m_program;
   XbmcThreads::EndTime  m_timeout;
 
+  CDVDDemuxSeekIndex m_seekIndex;
+  bool               m_useSeekIndex; ///< format seeks by scanning, so keep a keyframe index
+  std::string        m_seekIndexFile;
+
   CDVDInputStream* m_pInput;
 };
 
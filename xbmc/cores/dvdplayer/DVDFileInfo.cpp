@@ -26,6 +26,7 @@
 #include "video/VideoInfoTag.h"
 #include "filesystem/StackDirectory.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 
@@ -89,6 +90,30 @@ int DegreeToOrientation(int degrees)
   }
 }
 
+/*!
+ \brief Work out the ffmpeg lowres factor to decode a thumb with.
+ Halves the decoded size as long as the picture stays at least twice the
+ size of the thumb, limited to what the decoder supports.
+ \return lowres factor to use, 0 for full resolution
+ */
+static int GetThumbLowres(const CDVDStreamInfo &hint)
+{
+  DllAvCodec dllAvCodec;
+  if (!dllAvCodec.Load())
+    return 0;
+
+  int lowres = 0;
+  AVCodec *codec = dllAvCodec.avcodec_find_decoder(hint.codec);
+  if (codec && hint.width > 0)
+  {
+    int thumbSize = g_advancedSettings.GetThumbSize();
+    while (lowres < codec->max_lowres && (hint.width >> (lowres + 1)) >= thumbSize * 2)
+      lowres++;
+  }
+  dllAvCodec.Unload();
+  return lowres;
+}
+
 bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails)
 {
   unsigned int nTime = XbmcThreads::SystemClockMillis();
@@ -138,6 +163,9 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
   if (pStreamDetails)
     DemuxerToStreamDetails(pInputStream, pDemuxer, *pStreamDetails, strPath);
 
+  unsigned int nTimeOpen = XbmcThreads::SystemClockMillis();
+  unsigned int nTimeCodec = nTimeOpen, nTimeSeek = nTimeOpen, nTimeDecode = 0;
+
   CDemuxStream* pStream = NULL;
   int nVideoStream = -1;
   for (int i = 0; i < pDemuxer->GetNrOfStreams(); i++)
@@ -162,16 +190,26 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
+    // we only need a single keyframe scaled down to thumb size, so let ffmpeg
+    // skip everything but keyframes and decode at reduced resolution if the
+    // decoder supports it. libmpeg2 is not thread safe, so ffmpeg is used for
+    // mpeg2/mpeg1 as well.
+    CDVDCodecOptions dvdOptions;
+    dvdOptions.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+    int lowres = GetThumbLowres(hint);
+    if (lowres > 0)
+      dvdOptions.m_keys.push_back(CDVDCodecOption("lowres", StringUtils::Format("%d", lowres)));
+
+    pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+    if (!pVideoCodec && lowres > 0)
     {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
+      CLog::Log(LOGDEBUG, "%s - unable to open codec with lowres %d, retrying at full resolution", __FUNCTION__, lowres);
+      dvdOptions.m_keys.pop_back();
       pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
     }
-    else
-    {
+    if (!pVideoCodec)
       pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
+    nTimeCodec = XbmcThreads::SystemClockMillis();
 
     if (pVideoCodec)
     {
@@ -187,10 +225,19 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
         memset(&picture, 0, sizeof(picture));
 
+        nTimeSeek = XbmcThreads::SystemClockMillis();
+
         // num streams * 80 frames, should get a valid frame, if not abort.
         int abort_index = pDemuxer->GetNrOfStreams() * 80;
+        // streams without keyframes after the seek point (e.g. intra refresh)
+        // never produce a picture with nokey, so fall back to decoding all
+        // frames once half of the packet budget is used up.
+        int fullDecodeIndex = abort_index / 2;
         do
         {
+          if (abort_index == fullDecodeIndex)
+            pVideoCodec->SetDropState(false);
+
           pPacket = pDemuxer->Read();
           packetsTried++;
 
@@ -221,6 +268,8 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
         } while (abort_index--);
 
+        nTimeDecode = XbmcThreads::SystemClockMillis();
+
         if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
           {
@@ -278,8 +327,12 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
       file.Close();
   }
 
-  unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
+  unsigned int nTimeEnd = XbmcThreads::SystemClockMillis();
+  unsigned int nTotalTime = nTimeEnd - nTime;
   CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, strPath.c_str(), packetsTried);
+  if (nTimeDecode)
+    CLog::Log(LOGDEBUG,"%s - timing for <%s>: open %u ms, codec %u ms, seek %u ms, decode %u ms, scale %u ms", __FUNCTION__, strPath.c_str(),
+              nTimeOpen - nTime, nTimeCodec - nTimeOpen, nTimeSeek - nTimeCodec, nTimeDecode - nTimeSeek, nTimeEnd - nTimeDecode);
   return bOk;
 }
 
@@ -417,6 +417,7 @@ CDVDPlayer::CDVDPlayer(IPlayerCallback& callback)
   m_HasAudio = false;
 
   memset(&m_SpeedState, 0, sizeof(m_SpeedState));
+  memset(&m_channelSwitchTimes, 0, sizeof(m_channelSwitchTimes));
 
 #ifdef DVDDEBUG_MESSAGE_TRACKER
   g_dvdMessageTracker.Init();
@@ -626,6 +627,7 @@ bool CDVDPlayer::OpenInputStream()
   m_dvd.Clear();
   m_errorCount = 0;
   m_iChannelEntryTimeOut = 0;
+  ResetChannelSwitchTimes(0);
 
   return true;
 }
@@ -1058,13 +1060,22 @@ void CDVDPlayer::Process()
         break;
       }
 
+      if (m_channelSwitchTimes.start > 0)
+        m_channelSwitchTimes.demuxer = XbmcThreads::SystemClockMillis();
+
       OpenDefaultStreams();
 
+      if (m_channelSwitchTimes.start > 0)
+        m_channelSwitchTimes.streams = XbmcThreads::SystemClockMillis();
+
       // never allow first frames after open to be skipped
       if( m_dvdPlayerVideo.IsInited() )
         m_dvdPlayerVideo.SendMessage(new CDVDMsg(CDVDMsg::VIDEO_NOSKIP));
 
-      if (CachePVRStream())
+      // after a fast channel switch, start playing as soon as each stream has its first frame
+      if (m_channelSwitchTimes.start > 0 && FastChannelSwitch())
+        SetCaching(CACHESTATE_INIT);
+      else if (CachePVRStream())
         SetCaching(CACHESTATE_PVR);
 
       UpdateApplication(0);
@@ -2224,10 +2235,12 @@ void CDVDPlayer::HandleMessages()
       }
       else if (pMsg->IsType(CDVDMsg::PLAYER_CHANNEL_SELECT_NUMBER) && m_messenger.GetPacketCount(CDVDMsg::PLAYER_CHANNEL_SELECT_NUMBER) == 0)
       {
+        ResetChannelSwitchTimes(XbmcThreads::SystemClockMillis());
         FlushBuffers(false);
         CDVDInputStream::IChannel* input = dynamic_cast<CDVDInputStream::IChannel*>(m_pInputStream);
         if(input && input->SelectChannelByNumber(static_cast<CDVDMsgInt*>(pMsg)->m_value))
         {
+          m_channelSwitchTimes.input = XbmcThreads::SystemClockMillis();
           SAFE_DELETE(m_pDemuxer);
         }else
         {
@@ -2237,10 +2250,12 @@ void CDVDPlayer::HandleMessages()
       }
       else if (pMsg->IsType(CDVDMsg::PLAYER_CHANNEL_SELECT) && m_messenger.GetPacketCount(CDVDMsg::PLAYER_CHANNEL_SELECT) == 0)
       {
+        ResetChannelSwitchTimes(XbmcThreads::SystemClockMillis());
         FlushBuffers(false);
         CDVDInputStream::IChannel* input = dynamic_cast<CDVDInputStream::IChannel*>(m_pInputStream);
         if(input && input->SelectChannel(static_cast<CDVDMsgType <CPVRChannel> *>(pMsg)->m_value))
         {
+          m_channelSwitchTimes.input = XbmcThreads::SystemClockMillis();
           SAFE_DELETE(m_pDemuxer);
         }else
         {
@@ -2258,6 +2273,7 @@ void CDVDPlayer::HandleMessages()
 
           if (!bShowPreview)
           {
+            ResetChannelSwitchTimes(XbmcThreads::SystemClockMillis());
             g_infoManager.SetDisplayAfterSeek(100000);
             FlushBuffers(false);
           }
@@ -2277,6 +2293,7 @@ void CDVDPlayer::HandleMessages()
             else
             {
               m_iChannelEntryTimeOut = 0;
+              m_channelSwitchTimes.input = XbmcThreads::SystemClockMillis();
               SAFE_DELETE(m_pDemuxer);
 
               g_infoManager.SetDisplayAfterSeek();
@@ -2299,6 +2316,7 @@ void CDVDPlayer::HandleMessages()
         if(player == DVDPLAYER_VIDEO)
           m_CurrentVideo.started = true;
         CLog::Log(LOGDEBUG, "CDVDPlayer::HandleMessages - player started %d", player);
+        OnChannelSwitchStarted(player);
       }
       else if (pMsg->IsType(CDVDMsg::PLAYER_DISPLAYTIME))
       {
@@ -2835,8 +2853,7 @@ bool CDVDPlayer::OpenAudioStream(int iStream, int source, bool reset)
 
   CDVDStreamInfo hint(*pStream, true);
 
-  if(m_CurrentAudio.id    < 0
-  || m_CurrentAudio.hint != hint)
+  if(!CanReuseStream(m_CurrentAudio, hint))
   {
     if (!m_dvdPlayerAudio.OpenStream( hint ))
     {
@@ -2908,8 +2925,7 @@ bool CDVDPlayer::OpenVideoStream(int iStream, int source, bool reset)
   if(pMenus && pMenus->IsInMenu())
     hint.stills = true;
 
-  if(m_CurrentVideo.id    < 0
-  || m_CurrentVideo.hint != hint)
+  if(!CanReuseStream(m_CurrentVideo, hint))
   {
     if (!m_dvdPlayerVideo.OpenStream(hint))
     {
@@ -4152,3 +4168,63 @@ bool CDVDPlayer::CachePVRStream(void) const
       !g_PVRManager.IsPlayingRecording() &&
       g_advancedSettings.m_bPVRCacheInDvdPlayer;
 }
+
+bool CDVDPlayer::FastChannelSwitch(void) const
+{
+  return m_pInputStream && m_pInputStream->IsStreamType(DVDSTREAM_TYPE_PVRMANAGER) &&
+      !g_PVRManager.IsPlayingRecording() &&
+      g_advancedSettings.m_bPVRFastChannelSwitch;
+}
+
+bool CDVDPlayer::CanReuseStream(CCurrentStream& current, CDVDStreamInfo& hint)
+{
+  if (current.id < 0)
+    return false;
+
+  /* live tv streams repeat their codec headers in band and the decoders don't care about the bitrate,
+   * so after a fast channel switch the decoder is kept if only those changed */
+  if (m_channelSwitchTimes.start > 0 && FastChannelSwitch())
+  {
+    CDVDStreamInfo compare;
+    compare.Assign(hint, false);
+    compare.bitrate = current.hint.bitrate;
+    return current.hint.Equal(compare, false);
+  }
+
+  return current.hint == hint;
+}
+
+void CDVDPlayer::ResetChannelSwitchTimes(unsigned int start)
+{
+  m_channelSwitchTimes.start   = start;
+  m_channelSwitchTimes.input   = 0;
+  m_channelSwitchTimes.demuxer = 0;
+  m_channelSwitchTimes.streams = 0;
+}
+
+void CDVDPlayer::OnChannelSwitchStarted(int player)
+{
+  /* a switch is done when the first picture is shown, or the first audio is played for radio */
+  if (m_channelSwitchTimes.start == 0 || m_channelSwitchTimes.streams == 0 ||
+      (player != DVDPLAYER_VIDEO && m_CurrentVideo.id >= 0))
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  CLog::Log(LOGDEBUG, "CDVDPlayer::%s - channel switch took %u ms (input %u ms, demuxer %u ms, streams %u ms, first %s %u ms)",
+      __FUNCTION__, now - m_channelSwitchTimes.start,
+      m_channelSwitchTimes.input   - m_channelSwitchTimes.start,
+      m_channelSwitchTimes.demuxer - m_channelSwitchTimes.input,
+      m_channelSwitchTimes.streams - m_channelSwitchTimes.demuxer,
+      player == DVDPLAYER_VIDEO ? "picture" : "audio",
+      now - m_channelSwitchTimes.streams);
+
+  /* the pvr cache state loads these when it's done, but a fast switch skips it */
+  if (FastChannelSwitch())
+  {
+    CFileItem currentItem(g_application.CurrentFileItem());
+    if (currentItem.HasPVRChannelInfoTag())
+      g_PVRManager.LoadCurrentChannelSettings();
+  }
+
+  ResetChannelSwitchTimes(0);
+}
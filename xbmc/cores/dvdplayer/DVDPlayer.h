@@ -325,6 +325,10 @@ protected:
   bool IsValidStream(CCurrentStream& stream);
   bool IsBetterStream(CCurrentStream& current, CDemuxStream* stream);
   bool CheckDelayedChannelEntry(void);
+  bool FastChannelSwitch(void) const;
+  bool CanReuseStream(CCurrentStream& current, CDVDStreamInfo& hint);
+  void ResetChannelSwitchTimes(unsigned int start);
+  void OnChannelSwitchStarted(int player);
 
   bool OpenInputStream();
   bool OpenDemuxStream();
@@ -342,6 +346,14 @@ protected:
   CFileItem    m_item;
   unsigned int m_iChannelEntryTimeOut;
 
+  struct SChannelSwitchTimes
+  {
+    unsigned int start;   // channel switch requested, 0 if no switch is in progress
+    unsigned int input;   // input stream switched to the new channel
+    unsigned int demuxer; // demuxer opened on the new stream
+    unsigned int streams; // decoders opened or reused
+  } m_channelSwitchTimes;
+
 
   CCurrentStream m_CurrentAudio;
   CCurrentStream m_CurrentVideo;
@@ -118,8 +118,6 @@ CDVDPlayerAudio::CDVDPlayerAudio(CDVDClock* pClock, CDVDMessageQueue& parent)
   m_setsynctype = SYNC_DISCON;
   m_prevsynctype = -1;
   m_error = 0;
-  m_errorbuff = 0;
-  m_errorcount = 0;
   m_syncclock = true;
   m_integral = 0;
   m_skipdupcount = 0;
@@ -196,8 +194,7 @@ void CDVDPlayerAudio::OpenStream( CDVDStreamInfo &hints, CDVDAudioCodec* codec )
   m_prevsynctype = -1;
 
   m_error = 0;
-  m_errorbuff = 0;
-  m_errorcount = 0;
+  m_errorestimator.Reset();
   m_integral = 0;
   m_skipdupcount = 0;
   m_prevskipped = false;
@@ -662,8 +659,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
     if(m_speed == DVD_PLAYSPEED_NORMAL)
       CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity1 - was:%f, should be:%f, error:%f", clock, clock+error, error);
 
-    m_errorbuff = 0;
-    m_errorcount = 0;
+    m_errorestimator.Reset();
     m_skipdupcount = 0;
     m_error = 0;
     m_syncclock = false;
@@ -674,8 +670,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
 
   if (m_speed != DVD_PLAYSPEED_NORMAL)
   {
-    m_errorbuff = 0;
-    m_errorcount = 0;
+    m_errorestimator.Reset();
     m_integral = 0;
     m_skipdupcount = 0;
     m_error = 0;
@@ -683,18 +678,19 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
     return;
   }
 
-  m_errorbuff += error;
-  m_errorcount++;
+  //filter the error, the estimator tracks both the offset and the drift of the audio clock
+  now = CurrentHostCounter();
+  m_errorestimator.AddMeasurement((double)now / m_freq, error / DVD_TIME_BASE);
+
+  //the resampler corrects continuously, so let it follow the filtered error
+  if (m_synctype == SYNC_RESAMPLE)
+    m_error = m_errorestimator.GetOffset() * DVD_TIME_BASE;
 
   //check if measured error for 2 seconds
-  now = CurrentHostCounter();
   if ((now - m_errortime) >= m_freq * 2)
   {
     m_errortime = now;
-    m_error = m_errorbuff / m_errorcount;
-
-    m_errorbuff = 0;
-    m_errorcount = 0;
+    m_error = m_errorestimator.GetOffset() * DVD_TIME_BASE;
 
     if (m_synctype == SYNC_DISCON)
     {
@@ -720,6 +716,7 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
       if (fabs(error) > limit - 0.001)
       {
         m_pClock->Discontinuity(clock+error);
+        m_errorestimator.Correct(-error / DVD_TIME_BASE);
         if(m_speed == DVD_PLAYSPEED_NORMAL)
           CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Discontinuity2 - was:%f, should be:%f, error:%f", clock, clock+error, error);
       }
@@ -738,6 +735,10 @@ void CDVDPlayerAudio::HandleSyncError(double duration)
       else if (m_skipdupcount < 0)
         CLog::Log(LOGDEBUG, "CDVDPlayerAudio:: Skipping %i packet(s) of %.2f ms duration ",
                   m_skipdupcount * -1,  duration / DVD_TIME_BASE * 1000.0);
+
+      //the correction reaches the output with the latency of the audio buffer, start over
+      if (m_skipdupcount != 0)
+        m_errorestimator.Reset();
     }
     else if (m_synctype == SYNC_RESAMPLE)
     {
@@ -867,11 +868,20 @@ string CDVDPlayerAudio::GetPlayerInfo()
   if (m_synctype == SYNC_RESAMPLE)
     s << ", rr:" << fixed << setprecision(5) << 1.0 / m_resampleratio;
 
+  CDriftEstimator::Stats stats = GetSyncStats();
+  if (stats.measurements > 0)
+    s << ", drift:" << fixed << setprecision(1) << stats.drift * 1000000.0 << " ppm";
+
   s << ", att:" << fixed << setprecision(1) << log(GetCurrentAttenuation()) * 20.0f << " dB";
 
   return s.str();
 }
 
+CDriftEstimator::Stats CDVDPlayerAudio::GetSyncStats() const
+{
+  return m_errorestimator.GetStats();
+}
+
 int CDVDPlayerAudio::GetAudioBitrate()
 {
   return (int)m_audioStats.GetBitrate();
@@ -27,6 +27,7 @@
 #include "DVDDemuxers/DVDDemuxUtils.h"
 #include "DVDStreamInfo.h"
 #include "utils/BitstreamStats.h"
+#include "utils/DriftEstimator.h"
 
 #include "cores/AudioEngine/AEAudioFormat.h"
 
@@ -110,6 +111,9 @@ public:
   std::string GetPlayerInfo();
   int GetAudioBitrate();
 
+  /*! \brief state of the filter tracking the error between audio and clock */
+  CDriftEstimator::Stats GetSyncStats() const;
+
   // holds stream information for current playing stream
   CDVDStreamInfo m_streaminfo;
 
@@ -199,8 +203,7 @@ protected:
 
   void   SetSyncType(bool passthrough);
   void   HandleSyncError(double duration);
-  double m_errorbuff; //place to store average errors
-  int    m_errorcount;//number of errors stored
+  CDriftEstimator m_errorestimator; //filters the measured errors
   bool   m_syncclock;
 
   double m_integral; //integral correction for resampler
@@ -21,14 +21,19 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+namespace
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  bool OverlayStartsBefore(const CDVDOverlay* lhs, const CDVDOverlay* rhs)
+  {
+    return lhs->iPTSStartTime < rhs->iPTSStartTime;
+  }
+}
 
-  m_iSize = 0;
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+{
+  m_current = 0;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +43,67 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+  double maxStop = pOverlay->iPTSStopTime;
+  if (!m_maxStop.empty())
+    maxStop = std::max(maxStop, m_maxStop.back());
 
-  m_iSize++;
+  m_overlays.push_back(pOverlay);
+  m_maxStop.push_back(maxStop);
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
+  if (m_overlays.size() < 2)
     return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+
+  std::stable_sort(m_overlays.begin(), m_overlays.end(), OverlayStartsBefore);
+
+  for (size_t i = 0; i < m_overlays.size(); i++)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
-    {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
-    }
+    m_maxStop[i] = m_overlays[i]->iPTSStopTime;
+    if (i > 0)
+      m_maxStop[i] = std::max(m_maxStop[i], m_maxStop[i - 1]);
   }
+  m_current = 0;
+}
+
+size_t CDVDSubtitleLineCollection::Find(double iPts) const
+{
+  size_t pos = m_current;
+  if (pos >= m_overlays.size())
+    return pos;
+
+  // nothing before the current position is still showing, so the first
+  // line that hasn't ended is the first one where the running max reaches pts
+  if (pos == 0 || m_maxStop[pos - 1] < iPts)
+    return std::lower_bound(m_maxStop.begin() + pos, m_maxStop.end(), iPts) - m_maxStop.begin();
+
+  while (pos < m_overlays.size() && m_overlays[pos]->iPTSStopTime < iPts)
+    pos++;
+  return pos;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  m_current = Find(iPts);
+  if (m_current >= m_overlays.size())
+    return NULL;
 
-  if (m_pCurrent)
-  {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
-    {
-      m_pCurrent = m_pCurrent->pNext;
-    }
-
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
-
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
-  }
-  return pOverlay;
+  // advance to the next overlay
+  return m_overlays[m_current++];
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = 0;
 }
 
 void CDVDSubtitleLineCollection::Clear()
 {
-  ListElement* pElement = NULL;
-
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
-
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+  for (std::vector<CDVDOverlay*>::iterator it = m_overlays.begin(); it != m_overlays.end(); ++it)
+    (*it)->Release();
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_overlays.clear();
+  m_maxStop.clear();
+  m_current = 0;
 }
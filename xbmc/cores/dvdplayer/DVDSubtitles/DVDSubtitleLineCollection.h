@@ -22,12 +22,7 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <vector>
 
 class CDVDSubtitleLineCollection
 {
@@ -35,9 +30,6 @@ public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
@@ -45,16 +37,21 @@ public:
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_overlays.size(); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
-
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  /*! \brief Find the first overlay at or after the current position that
+   *         has not yet ended at the given pts.
+   *
+   * m_maxStop holds the running maximum of the stop times, which is
+   * non-decreasing, so when nothing before the current position is still
+   * showing the position can be found with a binary search instead of
+   * walking every line after a seek.
+   */
+  size_t Find(double iPts) const;
+
+  std::vector<CDVDOverlay*> m_overlays;
+  std::vector<double>       m_maxStop;
+  size_t                    m_current;
 };
-
@@ -44,6 +44,11 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
   m_library = NULL;
   m_renderer = NULL;
   m_references = 1;
+  m_image = NULL;
+  m_image_valid = false;
+  m_image_pts = 0;
+  m_image_width = 0;
+  m_image_height = 0;
 
   if(!m_dll.Load())
   {
@@ -116,6 +121,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   m_dll.ass_process_codec_private(m_track, data, size);
+  m_image_valid = false;
   return true;
 }
 
@@ -129,6 +135,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(char* data, int size, double start, dou
   }
 
   m_dll.ass_process_chunk(m_track, data, size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  m_image_valid = false;
   return true;
 }
 
@@ -144,6 +151,7 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf)
   CLog::Log(LOGINFO, "SSA Parser: Creating m_track from SSA buffer");
 
   m_track = m_dll.ass_read_memory(m_library, buf, 0, 0);
+  m_image_valid = false;
   if(m_track == NULL)
     return false;
 
@@ -159,8 +167,27 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int imageWidth, int imageHeight, dou
     return NULL;
   }
 
+  // the overlay is rendered for every gui frame, but only changes with the
+  // video frame. libass only tracks changes after doing the full layout, so
+  // skip it when we were asked for the very same frame
+  long long now = DVD_TIME_TO_MSEC(pts);
+  if(m_image_valid && now == m_image_pts && imageWidth == m_image_width && imageHeight == m_image_height)
+  {
+    if(changes)
+      *changes = 0;
+    return m_image;
+  }
+
+  int changed = 0;
   m_dll.ass_set_frame_size(m_renderer, imageWidth, imageHeight);
-  return m_dll.ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+  m_image = m_dll.ass_render_frame(m_renderer, m_track, now, &changed);
+  m_image_pts    = now;
+  m_image_width  = imageWidth;
+  m_image_height = imageHeight;
+  m_image_valid  = true;
+  if(changes)
+    *changes = changed;
+  return m_image;
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
@@ -48,5 +48,12 @@ private:
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
   CCriticalSection m_section;
+
+  /* last rendered frame, valid until the next call to ass_render_frame */
+  ASS_Image* m_image;
+  bool       m_image_valid;
+  long long  m_image_pts;
+  int        m_image_width;
+  int        m_image_height;
 };
 
@@ -103,6 +103,8 @@ void CDatabase::Filter::AppendGroup(const std::string &strGroup)
 CDatabase::CDatabase(void)
 {
   m_openCount = 0;
+  m_batch = false;
+  m_batchFailed = false;
   m_sqlite = true;
   m_bMultiWrite = false;
 }
@@ -575,6 +577,8 @@ void CDatabase::Close()
   }
 
   m_openCount = 0;
+  m_batch = false;
+  m_batchFailed = false;
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
@@ -627,6 +631,9 @@ void CDatabase::Interupt()
 
 void CDatabase::BeginTransaction()
 {
+  if (m_batch && InTransaction())
+    return;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -640,6 +647,9 @@ void CDatabase::BeginTransaction()
 
 bool CDatabase::CommitTransaction()
 {
+  if (m_batch)
+    return true;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -655,6 +665,10 @@ bool CDatabase::CommitTransaction()
 
 void CDatabase::RollbackTransaction()
 {
+  // this throws away the earlier writes of the batch too
+  if (m_batch)
+    m_batchFailed = true;
+
   try
   {
     if (NULL != m_pDB.get())
@@ -668,10 +682,33 @@ void CDatabase::RollbackTransaction()
 
 bool CDatabase::InTransaction()
 {
-  if (NULL != m_pDB.get()) return false;
+  if (NULL == m_pDB.get()) return false;
   return m_pDB->in_transaction();
 }
 
+void CDatabase::BeginBatch()
+{
+  BeginTransaction();
+  m_batch = true;
+  m_batchFailed = false;
+}
+
+bool CDatabase::CommitBatch()
+{
+  m_batch = false;
+  if (m_batchFailed)
+  {
+    // the writes after the rollback may refer to rows that no longer exist
+    m_batchFailed = false;
+    if (InTransaction())
+      RollbackTransaction();
+    return false;
+  }
+  if (!InTransaction())
+    return true;
+  return CommitTransaction();
+}
+
 bool CDatabase::CreateTables()
 {
 
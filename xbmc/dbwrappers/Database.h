@@ -71,6 +71,22 @@ public:
   void RollbackTransaction();
   bool InTransaction();
 
+  /*! \brief Group the writes that follow into a single transaction.
+   Until CommitBatch() is called, BeginTransaction() and CommitTransaction() from
+   the individual writes don't end the open transaction, so many small updates
+   share one commit. A RollbackTransaction() rolls back all writes of the batch
+   so far, and fails the batch.
+   \sa CommitBatch
+   */
+  void BeginBatch();
+
+  /*! \brief Commit the writes grouped since BeginBatch().
+   \return false if the batch failed to commit or a write in it was rolled back.
+   Nothing of the batch is stored in that case, so the caller should redo the writes.
+   \sa BeginBatch
+   */
+  bool CommitBatch();
+
   static CStdString FormatSQL(CStdString strStmt, ...);
   CStdString PrepareSQL(CStdString strStmt, ...) const;
 
@@ -173,4 +189,6 @@ private:
 
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
+  bool m_batch; /*!< True if transactions are grouped until CommitBatch() */
+  bool m_batchFailed; /*!< True if a transaction of the current batch was rolled back */
 };
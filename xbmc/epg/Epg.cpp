@@ -46,7 +46,8 @@ CEpg::CEpg(int iEpgID, const CStdString &strName /* = "" */, const CStdString &s
     m_iEpgID(iEpgID),
     m_strName(strName),
     m_strScraperName(strScraperName),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bQueuedLastScanTime(false)
 {
   CPVRChannelPtr empty;
   m_pvrChannel = empty;
@@ -61,7 +62,8 @@ CEpg::CEpg(CPVRChannelPtr channel, bool bLoadedFromDb /* = false */) :
     m_strName(channel->ChannelName()),
     m_strScraperName(channel->EPGScraper()),
     m_pvrChannel(channel),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bQueuedLastScanTime(false)
 {
 }
 
@@ -71,7 +73,8 @@ CEpg::CEpg(void) :
     m_bLoaded(false),
     m_bUpdatePending(false),
     m_iEpgID(0),
-    m_bUpdateLastScanTime(false)
+    m_bUpdateLastScanTime(false),
+    m_bQueuedLastScanTime(false)
 {
   CPVRChannelPtr empty;
   m_pvrChannel = empty;
@@ -94,6 +97,7 @@ CEpg &CEpg::operator =(const CEpg &right)
   m_nowActiveStart    = right.m_nowActiveStart;
   m_lastScanTime      = right.m_lastScanTime;
   m_pvrChannel        = right.m_pvrChannel;
+  m_maxTagSpan        = right.m_maxTagSpan;
 
   for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = right.m_tags.begin(); it != right.m_tags.end(); it++)
     m_tags.insert(make_pair(it->first, new CEpgInfoTag(*it->second)));
@@ -155,6 +159,7 @@ void CEpg::Clear(void)
 {
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_maxTagSpan = CDateTimeSpan();
 }
 
 void CEpg::Cleanup(void)
@@ -167,7 +172,8 @@ void CEpg::Cleanup(void)
 void CEpg::Cleanup(const CDateTime &Time)
 {
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end(); it != m_tags.end() ? it++ : it)
+  /* a tag never ends before its key, so everything after Time can stay */
+  for (map<CDateTime, CEpgInfoTagPtr>::iterator it = m_tags.begin(); it != m_tags.end() && it->first < Time; it != m_tags.end() ? it++ : it)
   {
     if (it->second->EndAsUTC() < Time)
     {
@@ -195,10 +201,9 @@ bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
 
   if (bUpdateIfNeeded)
   {
-    CDateTime lastActiveTag;
+    CDateTime now = CDateTime::GetUTCDateTime();
 
-    /* one of the first items will always match if the list is sorted */
-    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = FirstTagAround(now); it != m_tags.end(); it++)
     {
       if (it->second->IsActive())
       {
@@ -206,16 +211,20 @@ bool CEpg::InfoTagNow(CEpgInfoTag &tag, bool bUpdateIfNeeded /* = true */)
         tag = *it->second;
         return true;
       }
-      else if (it->second->WasActive())
-        lastActiveTag = it->first;
+      else if (it->first > now)
+        break;
     }
 
     /* there might be a gap between the last and next event. just return the last if found */
-    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.find(lastActiveTag);
-    if (it != m_tags.end())
+    map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.upper_bound(now);
+    while (it != m_tags.begin())
     {
-      tag = *it->second;
-      return true;
+      --it;
+      if (it->second->WasActive())
+      {
+        tag = *it->second;
+        return true;
+      }
     }
   }
 
@@ -237,8 +246,10 @@ bool CEpg::InfoTagNext(CEpgInfoTag &tag)
   }
   else if (Size() > 0)
   {
+    CSingleLock lock(m_critSection);
+
     /* return the first event that is in the future */
-    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = FirstTagAround(CDateTime::GetUTCDateTime()); it != m_tags.end(); it++)
     {
       if (it->second->InTheFuture())
       {
@@ -285,7 +296,7 @@ CEpgInfoTagPtr CEpg::GetTag(const CDateTime &StartTime) const
 CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &endTime) const
 {
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = FirstTagAround(beginTime); it != m_tags.end() && it->first <= endTime; it++)
   {
     if (it->second->StartAsUTC() >= beginTime && it->second->EndAsUTC() <= endTime)
       return it->second;
@@ -298,10 +309,12 @@ CEpgInfoTagPtr CEpg::GetTagBetween(const CDateTime &beginTime, const CDateTime &
 CEpgInfoTagPtr CEpg::GetTagAround(const CDateTime &time) const
 {
   CSingleLock lock(m_critSection);
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = FirstTagAround(time); it != m_tags.end(); it++)
   {
     if ((it->second->StartAsUTC() <= time) && (it->second->EndAsUTC() >= time))
       return it->second;
+    else if (it->first > time)
+      break;
   }
 
   CEpgInfoTagPtr retVal;
@@ -325,8 +338,10 @@ void CEpg::AddEntry(const CEpgInfoTag &tag)
   {
     newTag->Update(tag);
     newTag->SetPVRChannel(m_pvrChannel);
-    newTag->m_epg          = this;
-    newTag->m_bChanged     = false;
+    newTag->m_epg            = this;
+    newTag->m_bChanged       = false;
+    newTag->m_iPersistedHash = newTag->ContentHash();
+    UpdateMaxTagSpan(tag.StartAsUTC(), *newTag);
   }
 }
 
@@ -352,6 +367,7 @@ bool CEpg::UpdateEntry(const CEpgInfoTag &tag, bool bUpdateDatabase /* = false *
   infoTag->Update(tag, bNewTag);
   infoTag->m_epg          = this;
   infoTag->m_pvrChannel   = m_pvrChannel;
+  UpdateMaxTagSpan(tag.StartAsUTC(), *infoTag);
 
   if (bUpdateDatabase)
     m_changedTags.insert(make_pair<int, CEpgInfoTagPtr>(infoTag->UniqueBroadcastID(), infoTag));
@@ -517,9 +533,16 @@ int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
   if (!HasValidEntries())
     return -1;
 
+  /* only look at the tags inside the time window of the filter */
+  CDateTime endTime;
+  if (filter.m_endDateTime.IsValid())
+    endTime = filter.m_endDateTime.GetAsUTCDateTime();
+
   CSingleLock lock(m_critSection);
 
-  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+  map<CDateTime, CEpgInfoTagPtr>::const_iterator it = filter.m_startDateTime.IsValid() ?
+      FirstTagAround(filter.m_startDateTime.GetAsUTCDateTime()) : m_tags.begin();
+  for (; it != m_tags.end() && (!endTime.IsValid() || it->first <= endTime); it++)
   {
     if (filter.FilterEntry(*it->second))
       results.Add(CFileItemPtr(new CFileItem(*it->second)));
@@ -528,7 +551,7 @@ int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
   return results.Size() - iInitialSize;
 }
 
-bool CEpg::Persist(void)
+bool CEpg::Persist(bool bQueueWrite /* = false */)
 {
   if (g_guiSettings.GetBool("epg.ignoredbforclient") || !NeedsSave())
     return true;
@@ -554,13 +577,28 @@ bool CEpg::Persist(void)
     }
 
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_deletedTags.begin(); it != m_deletedTags.end(); it++)
-      database->Delete(*it->second);
+    {
+      database->Delete(*it->second, true);
+      m_queuedDeletes.insert(*it);
+    }
 
+    /* clients and scrapers hand us the whole schedule on every update. only write what differs from the database.
+       the tags are marked as stored by PersistDone(), once the queries were committed */
     for (std::map<int, CEpgInfoTagPtr>::iterator it = m_changedTags.begin(); it != m_changedTags.end(); it++)
-      it->second->Persist(false);
+    {
+      uint64_t iHash = it->second->ContentHash();
+      if (iHash == it->second->m_iPersistedHash)
+        continue;
+
+      if (database->Persist(*it->second, false) >= 0)
+        m_queuedTags.push_back(make_pair(it->second, iHash));
+    }
 
     if (m_bUpdateLastScanTime)
+    {
       database->PersistLastEpgScanTime(m_iEpgID, true);
+      m_bQueuedLastScanTime = true;
+    }
 
     m_deletedTags.clear();
     m_changedTags.clear();
@@ -569,7 +607,35 @@ bool CEpg::Persist(void)
     m_bUpdateLastScanTime = false;
   }
 
-  return database->CommitInsertQueries();
+  if (bQueueWrite)
+    return true;
+
+  bool bReturn = database->CommitInsertQueries();
+  PersistDone(bReturn);
+  return bReturn;
+}
+
+void CEpg::PersistDone(bool bCommitted)
+{
+  CSingleLock lock(m_critSection);
+  if (bCommitted)
+  {
+    for (std::vector<std::pair<CEpgInfoTagPtr, uint64_t> >::iterator it = m_queuedTags.begin(); it != m_queuedTags.end(); it++)
+      it->first->m_iPersistedHash = it->second;
+  }
+  else
+  {
+    /* write them again next time. tags that changed again in the meantime are already queued */
+    for (std::vector<std::pair<CEpgInfoTagPtr, uint64_t> >::iterator it = m_queuedTags.begin(); it != m_queuedTags.end(); it++)
+      m_changedTags.insert(make_pair(it->first->UniqueBroadcastID(), it->first));
+    m_deletedTags.insert(m_queuedDeletes.begin(), m_queuedDeletes.end());
+    m_bUpdateLastScanTime |= m_bQueuedLastScanTime;
+    m_bTagsChanged = !m_changedTags.empty() || !m_deletedTags.empty();
+  }
+
+  m_queuedTags.clear();
+  m_queuedDeletes.clear();
+  m_bQueuedLastScanTime = false;
 }
 
 CDateTime CEpg::GetFirstDate(void) const
@@ -661,6 +727,9 @@ bool CEpg::FixOverlappingEvents(bool bUpdateDb /* = false */)
     }
   }
 
+  /* start and end times were moved */
+  RebuildMaxTagSpan();
+
   return bReturn;
 }
 
@@ -825,6 +894,25 @@ CEpgInfoTagPtr CEpg::GetPreviousEvent(const CEpgInfoTag& tag) const
   return retVal;
 }
 
+map<CDateTime, CEpgInfoTagPtr>::const_iterator CEpg::FirstTagAround(const CDateTime &time) const
+{
+  return m_tags.lower_bound(time - m_maxTagSpan);
+}
+
+void CEpg::UpdateMaxTagSpan(const CDateTime &key, const CEpgInfoTag &tag)
+{
+  CDateTimeSpan span = tag.EndAsUTC() - key;
+  if (span > m_maxTagSpan)
+    m_maxTagSpan = span;
+}
+
+void CEpg::RebuildMaxTagSpan(void)
+{
+  m_maxTagSpan = CDateTimeSpan();
+  for (map<CDateTime, CEpgInfoTagPtr>::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    UpdateMaxTagSpan(it->first, *it->second);
+}
+
 CPVRChannelPtr CEpg::Channel(void) const
 {
   CSingleLock lock(m_critSection);
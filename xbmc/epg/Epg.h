@@ -237,10 +237,18 @@ namespace EPG
     int Get(CFileItemList &results, const EpgSearchFilter &filter) const;
 
     /*!
-     * @brief Persist this table in the database.
+     * @brief Persist this table in the database. Only tags whose content changed since they were last stored are written.
+     * @param bQueueWrite Queue the queries and leave committing them to the caller if true.
      * @return True if the table was persisted, false otherwise.
      */
-    bool Persist(void);
+    bool Persist(bool bQueueWrite = false);
+
+    /*!
+     * @brief Called once the queries queued by Persist() were committed.
+     * Only then the written tags are marked as stored. If the commit failed they are written again by the next Persist().
+     * @param bCommitted True if the queries were committed, false otherwise.
+     */
+    void PersistDone(bool bCommitted);
 
     /*!
      * @brief Get the start time of the first entry in this table.
@@ -339,9 +347,35 @@ namespace EPG
 
     bool IsRemovableTag(const EPG::CEpgInfoTag &tag) const;
 
+    /*!
+     * @brief Get the first tag in m_tags that can contain the given time.
+     *
+     * m_tags is ordered by start time and no tag lasts longer than m_maxTagSpan after its key,
+     * so only the tags from this position up to the first one that starts after the given time
+     * have to be checked. The caller must hold m_critSection.
+     * @param time The time to look up.
+     * @return The first candidate or m_tags.end().
+     */
+    std::map<CDateTime, CEpgInfoTagPtr>::const_iterator FirstTagAround(const CDateTime &time) const;
+
+    /*!
+     * @brief Extend m_maxTagSpan to cover the given tag.
+     * @param key The key of the tag in m_tags.
+     * @param tag The tag.
+     */
+    void UpdateMaxTagSpan(const CDateTime &key, const CEpgInfoTag &tag);
+
+    /*!
+     * @brief Recalculate m_maxTagSpan after the times of existing tags were changed.
+     */
+    void RebuildMaxTagSpan(void);
+
     std::map<CDateTime, CEpgInfoTagPtr> m_tags;
+    CDateTimeSpan                       m_maxTagSpan;      /*!< the longest time between the key of a tag in m_tags and its end time */
     std::map<int, CEpgInfoTagPtr>       m_changedTags;
     std::map<int, CEpgInfoTagPtr>       m_deletedTags;
+    std::vector<std::pair<CEpgInfoTagPtr, uint64_t> > m_queuedTags; /*!< tags written by Persist() and their ContentHash(), until the queries are committed */
+    std::map<int, CEpgInfoTagPtr>       m_queuedDeletes;   /*!< tags deleted by Persist(), until the queries are committed */
     bool                                m_bChanged;        /*!< true if anything changed that needs to be persisted, false otherwise */
     bool                                m_bTagsChanged;    /*!< true when any tags are changed and not persisted, false otherwise */
     bool                                m_bLoaded;         /*!< true when the initial entries have been loaded */
@@ -357,5 +391,6 @@ namespace EPG
 
     CCriticalSection                    m_critSection;     /*!< critical section for changes in this table */
     bool                                m_bUpdateLastScanTime;
+    bool                                m_bQueuedLastScanTime; /*!< true if Persist() wrote the last scan time, until the queries are committed */
   };
 }
@@ -26,6 +26,8 @@
 #include "dialogs/GUIDialogProgress.h"
 #include "guilib/GUIWindowManager.h"
 #include "guilib/LocalizeStrings.h"
+#include "utils/CPUInfo.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "pvr/PVRManager.h"
 #include "pvr/channels/PVRChannelGroupsContainer.h"
@@ -42,6 +44,38 @@ using namespace PVR;
 
 typedef std::map<int, CEpg*>::iterator EPGITR;
 
+/* don't bother spreading searches over less tables than this per job */
+#define EPG_SEARCH_MIN_TABLES_PER_JOB 25
+
+namespace EPG
+{
+  /*!
+   * @brief Apply a search filter to a slice of the EPG tables.
+   */
+  class CEpgSearchJob : public CJob
+  {
+  public:
+    CEpgSearchJob(const vector<CEpg *> &tables, const EpgSearchFilter &filter, CFileItemList &results) :
+      m_tables(tables),
+      m_filter(filter),
+      m_results(results) {}
+    virtual ~CEpgSearchJob() {}
+    virtual const char *GetType() const { return "epg-search"; }
+
+    virtual bool DoWork(void)
+    {
+      for (vector<CEpg *>::const_iterator it = m_tables.begin(); it != m_tables.end(); it++)
+        (*it)->Get(m_results, m_filter);
+      return true;
+    }
+
+  private:
+    vector<CEpg *>         m_tables;
+    const EpgSearchFilter &m_filter;
+    CFileItemList         &m_results;
+  };
+}
+
 CEpgContainer::CEpgContainer(void) :
     CThread("EPG updater")
 {
@@ -207,19 +241,34 @@ bool CEpgContainer::PersistTables(void)
 bool CEpgContainer::PersistAll(void)
 {
   bool bReturn(true);
+  vector<unsigned int> persisted;
   CSingleLock lock(m_critSection);
   for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end() && !m_bStop; it++)
   {
     CEpg *epg = it->second;
     if (epg && epg->NeedsSave())
     {
+      persisted.push_back(it->first);
       lock.Leave();
-      bReturn &= epg->Persist();
+      bReturn &= epg->Persist(true);
       lock.Enter();
     }
   }
+  lock.Leave();
 
-  return bReturn;
+  /* write the changes of all tables in a single transaction */
+  bool bCommitted = m_database.CommitInsertQueries();
+
+  /* tables may have been removed in the meantime, so look them up again */
+  lock.Enter();
+  for (vector<unsigned int>::const_iterator it = persisted.begin(); it != persisted.end(); it++)
+  {
+    map<unsigned int, CEpg *>::iterator epg = m_epgs.find(*it);
+    if (epg != m_epgs.end() && epg->second)
+      epg->second->PersistDone(bCommitted);
+  }
+
+  return bCommitted && bReturn;
 }
 
 void CEpgContainer::Process(void)
@@ -627,12 +676,50 @@ int CEpgContainer::GetEPGSearch(CFileItemList &results, const EpgSearchFilter &f
 {
   int iInitialSize = results.Size();
 
-  /* get filtered results from all tables */
+  /* tables are deleted under this lock, so keep it until all slices are searched.
+     the search jobs only take the locks of the tables themselves */
+  CSingleLock lock(m_critSection);
+  vector<CEpg *> tables;
+  tables.reserve(m_epgs.size());
+  for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
+    tables.push_back(it->second);
+
+  /* get filtered results from all tables, spread over the available cores on big lineups */
+  size_t iJobs = min((size_t) g_cpuInfo.getCPUCount(), tables.size() / EPG_SEARCH_MIN_TABLES_PER_JOB);
+  if (iJobs <= 1)
   {
-    CSingleLock lock(m_critSection);
-    for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
-      it->second->Get(results, filter);
+    for (vector<CEpg *>::iterator it = tables.begin(); it != tables.end(); it++)
+      (*it)->Get(results, filter);
   }
+  else
+  {
+    vector<CFileItemList *> sliceResults;
+    CJobWaiter jobs(iJobs);
+    size_t iSliceSize = (tables.size() + iJobs - 1) / iJobs;
+    for (size_t iJob = 0; iJob < iJobs; iJob++)
+    {
+      vector<CEpg *> slice(tables.begin() + min(iJob * iSliceSize, tables.size()),
+                           tables.begin() + min((iJob + 1) * iSliceSize, tables.size()));
+      sliceResults.push_back(new CFileItemList);
+
+      CEpgSearchJob *job = new CEpgSearchJob(slice, filter, *sliceResults.back());
+      if (!CJobManager::GetInstance().AddJob(job, &jobs, CJob::PRIORITY_HIGH))
+      {
+        job->DoWork();
+        jobs.OnJobComplete(0, true, job);
+        delete job;
+      }
+    }
+    jobs.Wait();
+
+    /* keep the results in table order */
+    for (vector<CFileItemList *>::iterator it = sliceResults.begin(); it != sliceResults.end(); it++)
+    {
+      results.Append(**it);
+      delete *it;
+    }
+  }
+  lock.Leave();
 
   /* remove duplicate entries */
   if (filter.m_bPreventRepeats)
@@ -210,7 +210,7 @@ namespace EPG
     bool IsInitialising(void) const;
 
     /*!
-     * @brief Call Persist() on each table
+     * @brief Call Persist() on each table and commit the changes in a single transaction.
      * @return True when they all were persisted, false otherwise.
      */
     bool PersistAll(void);
@@ -187,13 +187,26 @@ bool CEpgDatabase::DeleteOldEpgEntries(void)
   return DeleteValues("epgtags", strWhereClause);
 }
 
-bool CEpgDatabase::Delete(const CEpgInfoTag &tag)
+bool CEpgDatabase::Delete(const CEpgInfoTag &tag, bool bQueueWrite /* = false */)
 {
-  /* tag without a database ID was not persisted */
-  if (tag.BroadcastId() <= 0)
+  CStdString strWhereClause;
+  if (tag.BroadcastId() > 0)
+    strWhereClause = FormatSQL("idBroadcast = %u", tag.BroadcastId());
+  else if (tag.EpgID() > 0 && tag.m_iPersistedHash != 0)
+  {
+    /* tags that were written in a batch don't know their database ID. (idEpg, iStartTime) is unique */
+    time_t iStartTime;
+    tag.StartAsUTC().GetAsTime(iStartTime);
+    strWhereClause = FormatSQL("idEpg = %u AND iStartTime = %u", tag.EpgID(), iStartTime);
+  }
+  else
+  {
+    /* tag was not persisted */
     return false;
+  }
 
-  CStdString strWhereClause = FormatSQL("idBroadcast = %u", tag.BroadcastId());
+  if (bQueueWrite)
+    return QueueInsertQuery(FormatSQL("DELETE FROM epgtags WHERE %s;", strWhereClause.c_str()));
 
   return DeleteValues("epgtags", strWhereClause);
 }
@@ -86,9 +86,10 @@ namespace EPG
     /*!
      * @brief Remove a single EPG entry.
      * @param tag The entry to remove.
-     * @return True if it was removed successfully, false otherwise.
+     * @param bQueueWrite Don't execute the query immediately but queue it if true.
+     * @return True if it was removed (or queued) successfully, false otherwise.
      */
-    virtual bool Delete(const CEpgInfoTag &tag);
+    virtual bool Delete(const CEpgInfoTag &tag, bool bQueueWrite = false);
 
     /*!
      * @brief Get all EPG tables from the database. Does not get the EPG tables' entries.
@@ -48,6 +48,7 @@ CEpgInfoTag::CEpgInfoTag(void) :
     m_iEpisodeNumber(0),
     m_iEpisodePart(0),
     m_iUniqueBroadcastID(-1),
+    m_iPersistedHash(0),
     m_epg(NULL)
 {
   CPVRChannelPtr emptyChannel;
@@ -69,6 +70,7 @@ CEpgInfoTag::CEpgInfoTag(CEpg *epg, PVR::CPVRChannelPtr pvrChannel, const CStdSt
     m_iEpisodeNumber(0),
     m_iEpisodePart(0),
     m_iUniqueBroadcastID(-1),
+    m_iPersistedHash(0),
     m_strIconPath(strIconPath),
     m_epg(epg),
     m_pvrChannel(pvrChannel)
@@ -89,6 +91,7 @@ CEpgInfoTag::CEpgInfoTag(const EPG_TAG &data) :
     m_iEpisodeNumber(0),
     m_iEpisodePart(0),
     m_iUniqueBroadcastID(-1),
+    m_iPersistedHash(0),
     m_epg(NULL)
 {
   CPVRChannelPtr emptyChannel;
@@ -112,6 +115,7 @@ CEpgInfoTag::CEpgInfoTag(const CEpgInfoTag &tag) :
     m_iEpisodeNumber(tag.m_iEpisodeNumber),
     m_iEpisodePart(tag.m_iEpisodePart),
     m_iUniqueBroadcastID(tag.m_iUniqueBroadcastID),
+    m_iPersistedHash(tag.m_iPersistedHash),
     m_strTitle(tag.m_strTitle),
     m_strPlotOutline(tag.m_strPlotOutline),
     m_strPlot(tag.m_strPlot),
@@ -184,6 +188,7 @@ CEpgInfoTag &CEpgInfoTag::operator =(const CEpgInfoTag &other)
   m_iEpisodeNumber     = other.m_iEpisodeNumber;
   m_iEpisodePart       = other.m_iEpisodePart;
   m_iUniqueBroadcastID = other.m_iUniqueBroadcastID;
+  m_iPersistedHash     = other.m_iPersistedHash;
   m_strTitle           = other.m_strTitle;
   m_strPlotOutline     = other.m_strPlotOutline;
   m_strPlot            = other.m_strPlot;
@@ -933,6 +938,62 @@ bool CEpgInfoTag::Update(const CEpgInfoTag &tag, bool bUpdateBroadcastId /* = tr
   return bChanged;
 }
 
+/* 64 bit FNV-1a */
+static void HashBytes(uint64_t &hash, const void *data, size_t iSize)
+{
+  const unsigned char *bytes = (const unsigned char *)data;
+  for (size_t iPtr = 0; iPtr < iSize; iPtr++)
+  {
+    hash ^= bytes[iPtr];
+    hash *= 0x100000001b3ULL;
+  }
+}
+
+static void HashInt(uint64_t &hash, int64_t iValue)
+{
+  HashBytes(hash, &iValue, sizeof(iValue));
+}
+
+static void HashString(uint64_t &hash, const std::string &strValue)
+{
+  /* include the length so adjacent strings can't run into each other */
+  HashInt(hash, (int64_t)strValue.size());
+  HashBytes(hash, strValue.c_str(), strValue.size());
+}
+
+uint64_t CEpgInfoTag::ContentHash(void) const
+{
+  uint64_t hash = 0xcbf29ce484222325ULL;
+
+  CSingleLock lock(m_critSection);
+  time_t iStartTime, iEndTime, iFirstAired;
+  m_startTime.GetAsTime(iStartTime);
+  m_endTime.GetAsTime(iEndTime);
+  m_firstAired.GetAsTime(iFirstAired);
+
+  HashInt(hash, iStartTime);
+  HashInt(hash, iEndTime);
+  HashInt(hash, iFirstAired);
+  HashInt(hash, m_iGenreType);
+  HashInt(hash, m_iGenreSubType);
+  HashInt(hash, m_iParentalRating);
+  HashInt(hash, m_iStarRating);
+  HashInt(hash, m_bNotify ? 1 : 0);
+  HashInt(hash, m_iSeriesNumber);
+  HashInt(hash, m_iEpisodeNumber);
+  HashInt(hash, m_iEpisodePart);
+  HashInt(hash, m_iUniqueBroadcastID);
+  HashString(hash, m_strTitle);
+  HashString(hash, m_strPlotOutline);
+  HashString(hash, m_strPlot);
+  HashString(hash, m_strEpisodeName);
+  for (std::vector<std::string>::const_iterator it = m_genre.begin(); it != m_genre.end(); it++)
+    HashString(hash, *it);
+
+  /* 0 is reserved for tags that were never stored */
+  return hash ? hash : 1;
+}
+
 bool CEpgInfoTag::Persist(bool bSingleUpdate /* = true */)
 {
   bool bReturn = false;
@@ -415,6 +415,12 @@ namespace EPG
      */
     bool Persist(bool bSingleUpdate = true);
 
+    /*!
+     * @brief Get a hash of the values of this tag that are stored in the database.
+     * @return The hash.
+     */
+    uint64_t ContentHash(void) const;
+
     /*!
      * @brief Update the information in this tag with the info in the given tag.
      * @param tag The new info.
@@ -446,6 +452,7 @@ namespace EPG
     int                      m_iEpisodeNumber;     /*!< episode number */
     int                      m_iEpisodePart;       /*!< episode part number */
     int                      m_iUniqueBroadcastID; /*!< unique broadcast ID */
+    uint64_t                 m_iPersistedHash;     /*!< ContentHash() of the values that are stored in the database, 0 if not stored */
     CStdString               m_strTitle;           /*!< title */
     CStdString               m_strPlotOutline;     /*!< plot outline */
     CStdString               m_strPlot;            /*!< plot */
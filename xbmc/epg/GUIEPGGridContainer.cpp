@@ -55,6 +55,8 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_blockCursor           = 0;
   m_channelOffset         = 0;
   m_blockOffset           = 0;
+  m_blocks                = 0;
+  m_channels              = 0;
   m_channelScrollOffset   = 0;
   m_channelScrollSpeed    = 0;
   m_channelScrollLastTime = 0;
@@ -89,7 +91,6 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_cacheChannelItems     = preloadItems;
   m_cacheRulerItems       = preloadItems;
   m_cacheProgrammeItems   = preloadItems;
-  m_gridIndex             = NULL;
 }
 
 CGUIEPGGridContainer::~CGUIEPGGridContainer(void)
@@ -315,13 +316,14 @@ void CGUIEPGGridContainer::Render()
 
     int block = blockOffset;
     float posA2 = posA;
+    GridItemsPtr *gridRow = GetGridRow(channel);
 
-    CGUIListItemPtr item = m_gridIndex[channel][block].item;
-    if (blockOffset > 0 && item == m_gridIndex[channel][blockOffset-1].item)
+    CGUIListItemPtr item = gridRow[block].item;
+    if (blockOffset > 0 && item == gridRow[blockOffset-1].item)
     {
       /* first program starts before current view */
       int startBlock = blockOffset - 1;
-      while (startBlock >= 0 && m_gridIndex[channel][startBlock].item == item)
+      while (startBlock >= 0 && gridRow[startBlock].item == item)
         startBlock--;
 
       block = startBlock + 1;
@@ -331,11 +333,11 @@ void CGUIEPGGridContainer::Render()
 
     while (posA2 < endA && m_programmeItems.size())   // FOR EACH ITEM ///////////////
     {
-      item = m_gridIndex[channel][block].item;
+      item = gridRow[block].item;
       if (!item || !item.get()->IsFileItem())
         break;
 
-      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == m_gridIndex[m_channelOffset + m_channelCursor][m_blockOffset + m_blockCursor].item);
+      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == gridRow[m_blockOffset + m_blockCursor].item);
 
       // render our item
       if (focused)
@@ -351,27 +353,27 @@ void CGUIEPGGridContainer::Render()
           focusedPosY = posA2;
         }
         focusedItem = item;
-        focusedwidth = m_gridIndex[channel][block].width;
-        focusedheight = m_gridIndex[channel][block].height;
+        focusedwidth = gridRow[block].width;
+        focusedheight = gridRow[block].height;
       }
       else
       {
         if (m_orientation == VERTICAL)
-          RenderProgrammeItem(posA2, posB, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posA2, posB, gridRow[block].width, gridRow[block].height, item.get(), focused);
         else
-          RenderProgrammeItem(posB, posA2, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posB, posA2, gridRow[block].width, gridRow[block].height, item.get(), focused);
       }
 
       // increment our X position
       if (m_orientation == VERTICAL)
       {
-        posA2 += m_gridIndex[channel][block].width; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].width / m_blockSize);
+        posA2 += gridRow[block].width; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].width / m_blockSize);
       }
       else
       {
-        posA2 += m_gridIndex[channel][block].height; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].height / m_blockSize);
+        posA2 += gridRow[block].height; // assumes focused & unfocused layouts have equal length
+        block += (int)(gridRow[block].height / m_blockSize);
       }
     }
 
@@ -380,6 +382,9 @@ void CGUIEPGGridContainer::Render()
     posB += m_orientation == VERTICAL ? m_channelHeight : m_channelWidth;
   }
 
+  // Drop the grid rows that are no longer near the rendered ones, they're rebuilt when scrolled back in
+  FreeGridMemory(chanOffset - m_cacheChannelItems, channel + m_cacheChannelItems);
+
   // and render the focused item last (for overlapping purposes)
   if (focusedItem)
     RenderProgrammeItem(focusedPosX, focusedPosY, focusedwidth, focusedheight, focusedItem.get(), true);
@@ -708,15 +713,9 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
       for (int i = 0; i < items->Size(); i++)
         m_programmeItems.push_back(items->Get(i));
 
+      /* grid rows are only built for the channels that are shown, see GetGridRow() */
       ClearGridIndex();
-      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_channelItems.size()*sizeof(struct GridItemsPtr*));
-      if (m_gridIndex != NULL)
-      {
-        for (unsigned int i = 0; i < m_channelItems.size(); i++)
-        {
-          m_gridIndex[i] = (struct GridItemsPtr*) calloc(1,MAXBLOCKS*sizeof(struct GridItemsPtr));
-        }
-      }
+      m_gridIndex.assign(m_channelItems.size(), NULL);
 
       UpdateLayout(true); // true to refresh all items
 
@@ -755,7 +754,10 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
-  CDateTimeSpan blockDuration, gridDuration;
+  CDateTimeSpan gridDuration;
+
+  /* the rows depend on the block count, they are rebuilt when they're displayed again */
+  ClearGridIndex();
 
   /* check for invalid start and end time */
   if (m_gridStart >= m_gridEnd)
@@ -781,106 +783,116 @@ void CGUIEPGGridContainer::UpdateItems()
     return;
   }
 
+  m_channels = (int)m_epgItemsPtr.size();
+  m_item = GetItem(m_channelCursor);
+  if (m_item)
+    SetBlock(GetBlock(m_item->item, m_channelCursor));
+
+  SetInvalid();
+}
+
+GridItemsPtr *CGUIEPGGridContainer::GetGridRow(int channel) const
+{
+  if (!m_gridIndex[channel])
+    BuildGridRow(channel);
+
+  return m_gridIndex[channel];
+}
+
+void CGUIEPGGridContainer::BuildGridRow(int row) const
+{
+  CDateTimeSpan blockDuration;
   blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
 
-  long tick(XbmcThreads::SystemClockMillis());
+  /* one extra block, the size pass below compares every block with its successor */
+  GridItemsPtr *gridRow = new GridItemsPtr[m_blocks + 1]();
+  m_gridIndex[row] = gridRow;
 
-  for (unsigned int row = 0; row < m_channelItems.size(); ++row)
-  {
-    CDateTime gridCursor  = m_gridStart; //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[row].start;
-    unsigned long lastIdx = m_epgItemsPtr[row].stop;
-    int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
+  CDateTime gridCursor  = m_gridStart;
+  unsigned long progIdx = m_epgItemsPtr[row].start;
+  unsigned long lastIdx = m_epgItemsPtr[row].stop;
+  int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
 
-    /** FOR EACH BLOCK **********************************************************************/
+  /** FOR EACH BLOCK **********************************************************************/
 
-    for (int block = 0; block < m_blocks; block++)
+  for (int block = 0; block < m_blocks; block++)
+  {
+    while (progIdx <= lastIdx)
     {
-      while (progIdx <= lastIdx)
+      CGUIListItemPtr item = m_programmeItems[progIdx];
+      const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
+      if (tag == NULL)
       {
-        CGUIListItemPtr item = m_programmeItems[progIdx];
-        const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
-        if (tag == NULL)
-          progIdx++;
+        progIdx++;
+        continue;
+      }
 
-        if (tag->EpgID() != iEpgId)
-          break;
+      if (tag->EpgID() != iEpgId)
+        break;
 
-        if (m_gridEnd <= tag->StartAsUTC())
-        {
-          break;
-        }
-        else if (gridCursor >= tag->EndAsUTC())
-        {
-          progIdx++;
-        }
-        else if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[row][block].item = item;
-          break;
-        }
-        else
-        {
-          progIdx++;
-        }
+      if (m_gridEnd <= tag->StartAsUTC())
+      {
+        break;
+      }
+      else if (gridCursor >= tag->EndAsUTC())
+      {
+        progIdx++;
+      }
+      else if (gridCursor < tag->EndAsUTC())
+      {
+        gridRow[block].item = item;
+        break;
+      }
+      else
+      {
+        progIdx++;
       }
-
-      gridCursor += blockDuration;
     }
 
-    /** FOR EACH BLOCK **********************************************************************/
-    int itemSize = 1; // size of the programme in blocks
-    int savedBlock = 0;
+    gridCursor += blockDuration;
+  }
+
+  /** FOR EACH BLOCK **********************************************************************/
+  int itemSize = 1; // size of the programme in blocks
+  int savedBlock = 0;
 
-    for (int block = 0; block < m_blocks; block++)
+  for (int block = 0; block < m_blocks; block++)
+  {
+    if (gridRow[block].item != gridRow[block+1].item)
     {
-      if (m_gridIndex[row][block].item != m_gridIndex[row][block+1].item)
+      if (!gridRow[block].item)
       {
-        if (!m_gridIndex[row][block].item)
+        CEpgInfoTag broadcast;
+        CFileItemPtr unknown(new CFileItem(broadcast));
+        for (int i = block ; i > block - itemSize; i--)
         {
-          CEpgInfoTag broadcast;
-          CFileItemPtr unknown(new CFileItem(broadcast));
-          for (int i = block ; i > block - itemSize; i--)
-          {
-            m_gridIndex[row][i].item = unknown;
-          }
+          gridRow[i].item = unknown;
         }
+      }
 
-        CGUIListItemPtr item = m_gridIndex[row][block].item;
-        CFileItem *fileItem = (CFileItem *)item.get();
-
-        m_gridIndex[row][savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
-        if (m_orientation == VERTICAL)
-        {
-          m_gridIndex[row][savedBlock].width   = itemSize*m_blockSize;
-          m_gridIndex[row][savedBlock].height  = m_channelHeight;
-        }
-        else
-        {
-          m_gridIndex[row][savedBlock].width   = m_channelWidth;
-          m_gridIndex[row][savedBlock].height  = itemSize*m_blockSize;
-        }
+      CGUIListItemPtr item = gridRow[block].item;
+      CFileItem *fileItem = (CFileItem *)item.get();
 
-        itemSize = 1;
-        savedBlock = block+1;
+      gridRow[savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
+      if (m_orientation == VERTICAL)
+      {
+        gridRow[savedBlock].width   = itemSize*m_blockSize;
+        gridRow[savedBlock].height  = m_channelHeight;
       }
       else
       {
-        itemSize++;
+        gridRow[savedBlock].width   = m_channelWidth;
+        gridRow[savedBlock].height  = itemSize*m_blockSize;
       }
+
+      itemSize = 1;
+      savedBlock = block+1;
+    }
+    else
+    {
+      itemSize++;
     }
   }
-
-  /******************************************* END ******************************************/
-
-  CLog::Log(LOGDEBUG, "%s completed successfully in %u ms", __FUNCTION__, (unsigned int)(XbmcThreads::SystemClockMillis()-tick));
-
-  m_channels = (int)m_epgItemsPtr.size();
-  m_item = GetItem(m_channelCursor);
-  if (m_item)
-    SetBlock(GetBlock(m_item->item, m_channelCursor));
-
-  SetInvalid();
 }
 
 void CGUIEPGGridContainer::ChannelScroll(int amount)
@@ -957,7 +969,7 @@ bool CGUIEPGGridContainer::MoveChannel(bool direction, bool wrapAround)
 
 bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
 {
-  if (!m_gridIndex || !m_item)
+  if (m_gridIndex.empty() || !m_item)
     return false;
 
   if (direction)
@@ -965,7 +977,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
     if (m_channelCursor + m_channelOffset < 0 || m_blockOffset < 0)
       return false;
 
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blockOffset].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blockOffset].item)
     {
       // this is not first item on page
       m_item = GetPrevItem(m_channelCursor);
@@ -1014,7 +1026,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
   }
   else
   {
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blocksPerPage + m_blockOffset - 1].item)
+    if (m_item->item != GetGridRow(m_channelCursor + m_channelOffset)[m_blocksPerPage + m_blockOffset - 1].item)
     {
       // this is not last item on page
       m_item = GetNextItem(m_channelCursor);
@@ -1304,13 +1316,13 @@ bool CGUIEPGGridContainer::OnMouseWheel(char wheel, const CPoint &point)
 
 int CGUIEPGGridContainer::GetSelectedItem() const
 {
-  if (!m_gridIndex ||
+  if (m_gridIndex.empty() ||
       !m_epgItemsPtr.size() ||
       m_channelCursor + m_channelOffset >= (int)m_channelItems.size() ||
       m_blockCursor + m_blockOffset >= (int)m_programmeItems.size())
     return 0;
 
-  CGUIListItemPtr currentItem = m_gridIndex[m_channelCursor + m_channelOffset][m_blockCursor + m_blockOffset].item;
+  CGUIListItemPtr currentItem = GetGridRow(m_channelCursor + m_channelOffset)[m_blockCursor + m_blockOffset].item;
   if (!currentItem)
     return 0;
 
@@ -1397,9 +1409,9 @@ GridItemsPtr *CGUIEPGGridContainer::GetClosestItem(const int &channel)
   }
 
   if (right <= SHORTGAP && right <= left && m_blockCursor + right < m_blocksPerPage)
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + right + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + right + m_blockOffset];
 
-  return &m_gridIndex[channel + m_channelOffset][m_blockCursor - left  + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[m_blockCursor - left  + m_blockOffset];
 }
 
 int CGUIEPGGridContainer::GetItemSize(GridItemsPtr *item)
@@ -1422,7 +1434,7 @@ int CGUIEPGGridContainer::GetRealBlock(const CGUIListItemPtr &item, const int &c
 {
   int block = 0;
 
-  while (m_gridIndex[channel + m_channelOffset][block].item != item && block < m_blocks)
+  while (GetGridRow(channel + m_channelOffset)[block].item != item && block < m_blocks)
     block++;
 
   return block;
@@ -1432,28 +1444,28 @@ GridItemsPtr *CGUIEPGGridContainer::GetNextItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
     i++;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetPrevItem(const int &channel)
 {
   int i = m_blockCursor;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i > 0)
+  while (GetGridRow(channel + m_channelOffset)[i + m_blockOffset].item == GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset].item && i > 0)
     i--;
 
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return &GetGridRow(channel + m_channelOffset)[i + m_blockOffset];
 
-//  return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset - 1];
+//  return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset - 1];
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetItem(const int &channel)
 {
   if ( (channel >= 0) && (channel < m_channels) )
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset];
+    return &GetGridRow(channel + m_channelOffset)[m_blockCursor + m_blockOffset];
   else
     return NULL;
 }
@@ -1634,19 +1646,21 @@ CStdString CGUIEPGGridContainer::GetDescription() const
 
 void CGUIEPGGridContainer::ClearGridIndex(void)
 {
-  if (m_gridIndex)
+  for (unsigned int i = 0; i < m_gridIndex.size(); i++)
   {
-    for (unsigned int i = 0; i < m_channelItems.size(); i++)
+    if (!m_gridIndex[i])
+      continue;
+
+    for (int block = 0; block < m_blocks; block++)
     {
-      for (int block = 0; block < m_blocks; block++)
-      {
-        if (m_gridIndex[i][block].item)
-          m_gridIndex[i][block].item.get()->ClearProperties();
-      }
-      free(m_gridIndex[i]);
+      if (m_gridIndex[i][block].item)
+        m_gridIndex[i][block].item.get()->ClearProperties();
     }
-    free(m_gridIndex);
+    delete[] m_gridIndex[i];
+    m_gridIndex[i] = NULL;
   }
+
+  m_item = NULL;
 }
 
 void CGUIEPGGridContainer::Reset()
@@ -1661,7 +1675,7 @@ void CGUIEPGGridContainer::Reset()
 
   m_lastItem    = NULL;
   m_lastChannel = NULL;
-  m_gridIndex   = NULL;
+  m_gridIndex.clear();
 }
 
 void CGUIEPGGridContainer::GoToBegin()
@@ -1677,10 +1691,10 @@ void CGUIEPGGridContainer::GoToEnd()
   int blockOffset = 0; // the block offset to scroll to
   for (int blockIndex = m_blocks; blockIndex >= 0 && (!blocksEnd || !blocksStart); blockIndex--)
   {
-    if (!blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item != NULL)
+    if (!blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item != NULL)
       blocksEnd = blockIndex;
-    if (blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blocksEnd].item != 
-                     m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item)
+    if (blocksEnd && GetGridRow(m_channelCursor + m_channelOffset)[blocksEnd].item != 
+                     GetGridRow(m_channelCursor + m_channelOffset)[blockIndex].item)
       blocksStart = blockIndex + 1;
   }
   if (blocksEnd - blocksStart > m_blocksPerPage)
@@ -1868,6 +1882,24 @@ void CGUIEPGGridContainer::FreeChannelMemory(int keepStart, int keepEnd)
   }
 }
 
+void CGUIEPGGridContainer::FreeGridMemory(int keepStart, int keepEnd)
+{
+  /* the selected row is always kept. so is the row m_item points into, which
+     differs from the selected one after the offset changed without moving the cursor */
+  int selectedRow = m_channelOffset + m_channelCursor;
+
+  for (int i = 0; i < (int)m_gridIndex.size(); ++i)
+  {
+    if (!m_gridIndex[i] || i == selectedRow || (i >= keepStart && i <= keepEnd))
+      continue;
+    if (m_item && m_item >= m_gridIndex[i] && m_item <= m_gridIndex[i] + m_blocks)
+      continue;
+
+    delete[] m_gridIndex[i];
+    m_gridIndex[i] = NULL;
+  }
+}
+
 void CGUIEPGGridContainer::FreeProgrammeMemory(int keepStart, int keepEnd)
 {
   if (keepStart < keepEnd)
@@ -112,6 +112,14 @@ namespace EPG
     void Reset();
     void ClearGridIndex(void);
 
+    /*!
+     * \brief Get the grid row of a channel, building it on first access.
+     * \param channel The absolute index of the channel.
+     * \return The m_blocks + 1 grid items of the channel.
+     */
+    GridItemsPtr *GetGridRow(int channel) const;
+    void BuildGridRow(int row) const;
+
     GridItemsPtr *GetItem(const int &channel);
     GridItemsPtr *GetNextItem(const int &channel);
     GridItemsPtr *GetPrevItem(const int &channel);
@@ -168,6 +176,7 @@ namespace EPG
     void FreeChannelMemory(int keepStart, int keepEnd);
     void FreeProgrammeMemory(int keepStart, int keepEnd);
     void FreeRulerMemory(int keepStart, int keepEnd);
+    void FreeGridMemory(int keepStart, int keepEnd);
 
     void GetChannelCacheOffsets(int &cacheBefore, int &cacheAfter);
     void GetProgrammeCacheOffsets(int &cacheBefore, int &cacheAfter);
@@ -206,7 +215,7 @@ namespace EPG
     CDateTime m_gridStart;
     CDateTime m_gridEnd;
 
-    struct GridItemsPtr **m_gridIndex;
+    mutable std::vector<GridItemsPtr *> m_gridIndex; //! grid rows per channel, NULL until the row is needed
     GridItemsPtr *m_item;
     CGUIListItem *m_lastItem;
     CGUIListItem *m_lastChannel;
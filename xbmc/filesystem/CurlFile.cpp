@@ -52,6 +52,9 @@ using namespace XCURL;
 
 #define dllselect select
 
+/* number of transfers a batch runs at the same time */
+#define BATCH_MAX_TRANSFERS 8
+
 
 curl_proxytype proxyType2CUrlProxyType[] = {
   CURLPROXY_HTTP,
@@ -489,8 +492,12 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  // reuse dns lookups and ssl sessions of other handles
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -864,6 +871,174 @@ bool CCurlFile::Download(const CStdString& strURL, const CStdString& strFileName
   return true;
 }
 
+bool CCurlFile::GetBatch(const std::vector<CStdString>& strURLs, std::vector<CStdString>& strHTMLs)
+{
+  strHTMLs.assign(strURLs.size(), "");
+  if (strURLs.empty())
+    return true;
+
+  m_opened = true;
+  m_postdata = "";
+  m_postdataset = false;
+
+  // protocol options of one url must not carry over to the next one
+  CStdString referer(m_referer);
+  CStdString cookie(m_cookie);
+  CStdString contentencoding(m_contentencoding);
+  CStdString userAgent(m_userAgent);
+  MAPHTTPHEADERS requestheaders(m_requestheaders);
+
+  std::vector<CReadState*> states;
+  std::vector<struct curl_slist*> headerLists;
+  for (unsigned int i = 0; i < strURLs.size(); i++)
+  {
+    m_referer = referer;
+    m_cookie = cookie;
+    m_contentencoding = contentencoding;
+    m_userAgent = userAgent;
+    m_requestheaders = requestheaders;
+
+    CURL url(strURLs[i]);
+    ParseAndCorrectUrl(url);
+
+    CLog::Log(LOGDEBUG, "CCurlFile::GetBatch(%p) %s", (void*)this, m_url.c_str());
+
+    CReadState* state = new CReadState();
+    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), &state->m_easyHandle, NULL);
+
+    SetCommonOptions(state);
+    SetRequestHeaders(state);
+
+    // the header list has to live until this transfer is done
+    headerLists.push_back(m_curlHeaderList);
+    m_curlHeaderList = NULL;
+
+    state->m_buffer.Create(m_bufferSize);
+    states.push_back(state);
+  }
+
+  m_referer = referer;
+  m_cookie = cookie;
+  m_contentencoding = contentencoding;
+  m_userAgent = userAgent;
+  m_requestheaders = requestheaders;
+
+  // run all transfers on one pooled multi handle, so they share its connections
+  CURLM* multi = NULL;
+  g_curlInterface.multi_aquire(&multi);
+
+  std::vector<bool> succeeded(states.size(), false);
+  unsigned int next;
+  for (next = 0; next < states.size() && next < BATCH_MAX_TRANSFERS; next++)
+    g_curlInterface.multi_add_handle(multi, states[next]->m_easyHandle);
+
+  int running = 0;
+  while (!m_state->m_cancelled)
+  {
+    CURLMcode result;
+    while ((result = g_curlInterface.multi_perform(multi, &running)) == CURLM_CALL_MULTI_PERFORM);
+    if (result != CURLM_OK)
+    {
+      CLog::Log(LOGERROR, "%s - curl multi perform failed with code %d, aborting", __FUNCTION__, result);
+      break;
+    }
+
+    // collect finished transfers and start queued ones in their place
+    bool added = false;
+    int msgs;
+    CURLMsg* msg;
+    while ((msg = g_curlInterface.multi_info_read(multi, &msgs)))
+    {
+      if (msg->msg != CURLMSG_DONE)
+        continue;
+
+      CURL_HANDLE* easy = msg->easy_handle;
+      CURLcode code = msg->data.result;
+      for (unsigned int i = 0; i < next; i++)
+      {
+        if (states[i]->m_easyHandle != easy)
+          continue;
+
+        if (code == CURLE_OK)
+          succeeded[i] = true;
+        else
+          CLog::Log(LOGWARNING, "%s - curl failed with code %i for %s", __FUNCTION__, code, strURLs[i].c_str());
+        break;
+      }
+      g_curlInterface.multi_remove_handle(multi, easy);
+
+      if (next < states.size())
+      {
+        g_curlInterface.multi_add_handle(multi, states[next++]->m_easyHandle);
+        added = true;
+      }
+    }
+
+    if (added)
+      continue;
+    if (!running)
+      break;
+
+    fd_set fdread;
+    fd_set fdwrite;
+    fd_set fdexcep;
+    int maxfd = -1;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+
+    g_curlInterface.multi_fdset(multi, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+    long timeout = 0;
+    if (CURLM_OK != g_curlInterface.multi_timeout(multi, &timeout) || timeout == -1)
+      timeout = 200;
+
+    struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+
+    if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+    {
+      CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
+      break;
+    }
+  }
+
+  bool success = !m_state->m_cancelled;
+  for (unsigned int i = 0; i < states.size(); i++)
+  {
+    CReadState* state = states[i];
+
+    // removing a handle that is not running is a no-op
+    if (i < next)
+      g_curlInterface.multi_remove_handle(multi, state->m_easyHandle);
+
+    if (succeeded[i])
+    {
+      // data fills the ring buffer first, the rest ends up in the overflow buffer
+      unsigned int size = state->m_buffer.getMaxReadSize();
+      if (size)
+      {
+        char* buffer = new char[size];
+        if (state->m_buffer.ReadData(buffer, size))
+          strHTMLs[i].append(buffer, size);
+        delete[] buffer;
+      }
+      if (state->m_overflowSize)
+        strHTMLs[i].append(state->m_overflowBuffer, state->m_overflowSize);
+    }
+    else
+      success = false;
+
+    delete state;
+    if (headerLists[i])
+      g_curlInterface.slist_free_all(headerLists[i]);
+  }
+
+  g_curlInterface.multi_release(&multi);
+
+  m_opened = false;
+  return success;
+}
+
 // Detect whether we are "online" or not! Very simple and dirty!
 bool CCurlFile::IsInternet(bool checkDNS /* = true */)
 {
@@ -22,6 +22,7 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <vector>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -65,6 +66,9 @@ namespace XFILE
 
       bool Post(const CStdString& strURL, const CStdString& strPostData, CStdString& strHTML);
       bool Get(const CStdString& strURL, CStdString& strHTML);
+      /* fetch several urls at once, reusing pooled connections. strHTMLs is in the */
+      /* order of strURLs and empty for urls that failed. true if all succeeded     */
+      bool GetBatch(const std::vector<CStdString>& strURLs, std::vector<CStdString>& strHTMLs);
       bool ReadData(CStdString& strHTML);
       bool Download(const CStdString& strURL, const CStdString& strFileName, LPDWORD pdwSize = NULL);
       bool IsInternet(bool checkDNS = true);
@@ -19,9 +19,16 @@
  */
 
 #include "DirectoryCache.h"
+#include "DirectoryFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "FileItem.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Crc32.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "climits"
@@ -29,10 +36,58 @@
 using namespace std;
 using namespace XFILE;
 
+namespace XFILE
+{
+  /*!
+   \brief Refreshes a cached listing in the background.
+   */
+  class CDirectoryRevalidateJob : public CJob
+  {
+  public:
+    CDirectoryRevalidateJob(const CStdString &path, long revalidation, int flags)
+      : m_path(path), m_revalidation(revalidation), m_flags(flags) {}
+
+    virtual const char *GetType() const { return "directoryrevalidate"; }
+
+    virtual bool DoWork()
+    {
+      CStdString realPath = URIUtils::SubstitutePath(m_path);
+      auto_ptr<IDirectory> directory(CDirectoryFactory::Create(realPath));
+      if (directory.get())
+      {
+        CFileItemList items;
+        items.SetPath(m_path);
+        directory->SetFlags(m_flags);
+        if (directory->GetDirectory(realPath, items))
+        {
+          DIR_CACHE_TYPE cacheType = directory->GetCacheType(m_path);
+          if (cacheType != DIR_CACHE_NEVER)
+          {
+            g_directoryCache.RevalidationDone(m_path, m_revalidation, &items, cacheType);
+            return true;
+          }
+        }
+      }
+
+      CLog::Log(LOGDEBUG, "%s - unable to refresh %s", __FUNCTION__, m_path.c_str());
+      g_directoryCache.RevalidationDone(m_path, m_revalidation, NULL, DIR_CACHE_NEVER);
+      return false;
+    }
+
+  private:
+    CStdString m_path;
+    long m_revalidation;
+    int m_flags;
+  };
+}
+
 CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
 {
   m_cacheType = cacheType;
   m_lastAccess = 0;
+  m_size = 0;
+  m_cachedTime = XbmcThreads::SystemClockMillis();
+  m_revalidation = 0;
   m_Items = new CFileItemList;
   m_Items->SetFastLookup(true);
 }
@@ -42,33 +97,38 @@ CDirectoryCache::CDir::~CDir()
   delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+void CDirectoryCache::CDir::SetLastAccess(volatile long &accessCounter)
+{
+  m_lastAccess = (unsigned int)AtomicIncrement(&accessCounter);
+}
+
+bool CDirectoryCache::CDir::IsExpired(unsigned int now) const
 {
-  m_lastAccess = accessCounter++;
+  unsigned int maxAge = g_advancedSettings.m_directoryCacheRevalidateAge;
+  return maxAge > 0 && now - m_cachedTime > maxAge * 1000;
 }
 
 CDirectoryCache::CDirectoryCache(void)
 {
+  m_size = 0;
   m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
+  m_revalidations = 0;
 }
 
 CDirectoryCache::~CDirectoryCache(void)
 {
+  Clear();
 }
 
-bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll)
+bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll, int flags)
 {
-  CSingleLock lock (m_cs);
+  CStdString storedPath = GetStoredPath(strPath);
+  CShard &shard = GetShard(storedPath);
 
-  CStdString storedPath = URIUtils::SubstitutePath(strPath);
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  CSingleLock lock (shard.m_cs);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  ciCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
     CDir* dir = i->second;
     if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
@@ -76,12 +136,15 @@ bool CDirectoryCache::GetDirectory(const CStdString& strPath, CFileItemList &ite
     {
       items.Copy(*dir->m_Items);
       dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
+      shard.m_hits++;
+
+      // serve the stale listing but get a fresh one for next time
+      if (!dir->m_revalidation && dir->IsExpired(XbmcThreads::SystemClockMillis()))
+        Revalidate(storedPath, dir, flags);
       return true;
     }
   }
+  shard.m_misses++;
   return false;
 }
 
@@ -101,19 +164,19 @@ void CDirectoryCache::SetDirectory(const CStdString& strPath, const CFileItemLis
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
-
-  CStdString storedPath = URIUtils::SubstitutePath(strPath);
-  URIUtils::RemoveSlashAtEnd(storedPath);
-
-  ClearDirectory(storedPath);
-
-  CheckIfFull();
+  CStdString storedPath = GetStoredPath(strPath);
 
+  // do the (expensive) copy before taking the lock
   CDir* dir = new CDir(cacheType);
   dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
+  dir->m_size = EstimateSize(*dir->m_Items);
+
+  {
+    CShard &shard = GetShard(storedPath);
+    CSingleLock lock (shard.m_cs);
+    Insert(shard, storedPath, dir);
+  }
+  CheckIfFull(storedPath);
 }
 
 void CDirectoryCache::ClearFile(const CStdString& strFile)
@@ -125,86 +188,123 @@ void CDirectoryCache::ClearFile(const CStdString& strFile)
 
 void CDirectoryCache::ClearDirectory(const CStdString& strPath)
 {
-  CSingleLock lock (m_cs);
+  CStdString storedPath = GetStoredPath(strPath);
+  CShard &shard = GetShard(storedPath);
 
-  CStdString storedPath = URIUtils::SubstitutePath(strPath);
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  CSingleLock lock (shard.m_cs);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
 }
 
 void CDirectoryCache::ClearSubPaths(const CStdString& strPath)
 {
-  CSingleLock lock (m_cs);
+  CStdString storedPath = GetStoredPath(strPath);
 
-  CStdString storedPath = URIUtils::SubstitutePath(strPath);
-  URIUtils::RemoveSlashAtEnd(storedPath);
-
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (unsigned int s = 0; s < NUM_SHARDS; s++)
   {
-    CStdString path = i->first;
-    if (strncmp(path.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
-      Delete(i++);
-    else
-      i++;
+    CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+    {
+      if (strncmp(i->first.c_str(), storedPath.c_str(), storedPath.GetLength()) == 0)
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const CStdString& strFile)
 {
-  CSingleLock lock (m_cs);
-
   CStdString strPath;
   URIUtils::GetDirectory(strFile, strPath);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard &shard = GetShard(strPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(strPath);
+  if (i != shard.m_cache.end())
   {
     CDir *dir = i->second;
     CFileItemPtr item(new CFileItem(strFile, false));
+    size_t size = EstimateSize(*item);
     dir->m_Items->Add(item);
+    dir->m_size += size;
+    shard.m_size += size;
+    AtomicAdd(&m_size, (long)size);
     dir->SetLastAccess(m_accessCounter);
+    // a refresh listed before the file was added may not have it
+    dir->m_revalidation = 0;
+    lock.Leave();
+    CheckIfFull(strPath);
   }
 }
 
 bool CDirectoryCache::FileExists(const CStdString& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   CStdString strPath;
   URIUtils::GetDirectory(strFile, strPath);
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard &shard = GetShard(strPath);
+  CSingleLock lock (shard.m_cs);
+
+  ciCache i = shard.m_cache.find(strPath);
+  // an outdated listing can't tell that a file doesn't exist anymore
+  if (i != shard.m_cache.end() && !i->second->IsExpired(XbmcThreads::SystemClockMillis()))
   {
     bInCache = true;
     CDir *dir = i->second;
     dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
+    shard.m_hits++;
     return dir->m_Items->Contains(strFile);
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
+  shard.m_misses++;
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (unsigned int s = 0; s < NUM_SHARDS; s++)
+  {
+    CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
+
+    iCache i = shard.m_cache.begin();
+    while (i != shard.m_cache.end())
+      Delete(shard, i++);
+  }
+}
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+void CDirectoryCache::GetStatistics(Statistics &stats) const
+{
+  stats.hits = 0;
+  stats.misses = 0;
+  stats.bytes = 0;
+  stats.maxBytes = g_advancedSettings.m_directoryCacheSize;
+  stats.directories = 0;
+  stats.items = 0;
+
+  for (unsigned int s = 0; s < NUM_SHARDS; s++)
+  {
+    const CShard &shard = m_shards[s];
+    CSingleLock lock (shard.m_cs);
+
+    stats.hits += shard.m_hits;
+    stats.misses += shard.m_misses;
+    stats.bytes += shard.m_size;
+    stats.directories += shard.m_cache.size();
+    for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      stats.items += i->second->m_Items->Size();
+  }
 }
 
 void CDirectoryCache::InitCache(set<CStdString>& dirs)
@@ -221,61 +321,156 @@ void CDirectoryCache::InitCache(set<CStdString>& dirs)
 
 void CDirectoryCache::ClearCache(set<CStdString>& dirs)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
-  {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
-  }
+  for (set<CStdString>::const_iterator it = dirs.begin(); it != dirs.end(); ++it)
+    ClearDirectory(*it);
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::CheckIfFull(const CStdString &keepPath)
 {
-  CSingleLock lock (m_cs);
-  static const unsigned int max_cached_dirs = 10;
+  size_t maxSize = g_advancedSettings.m_directoryCacheSize;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // remove the least recently accessed folders of all shards until the cache fits in again.
+  // Only one shard is locked at a time: the oldest folder is looked up first, and removed
+  // afterwards unless it was accessed in between.
+  while ((size_t)m_size > maxSize)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    int oldestShard = -1;
+    CStdString oldestPath;
+    unsigned int oldestAccess = 0;
+    for (unsigned int s = 0; s < NUM_SHARDS; s++)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      CShard &shard = m_shards[s];
+      CSingleLock lock (shard.m_cs);
+      for (ciCache i = shard.m_cache.begin(); i != shard.m_cache.end(); i++)
+      {
+        // ensure dirs that are always cached aren't cleared
+        if (i->second->m_cacheType != DIR_CACHE_ALWAYS && i->first != keepPath &&
+           (oldestShard < 0 || i->second->GetLastAccess() < oldestAccess))
+        {
+          oldestShard = s;
+          oldestPath = i->first;
+          oldestAccess = i->second->GetLastAccess();
+        }
+      }
     }
+    if (oldestShard < 0)
+      break;
+
+    CShard &shard = m_shards[oldestShard];
+    CSingleLock lock (shard.m_cs);
+    iCache i = shard.m_cache.find(oldestPath);
+    if (i != shard.m_cache.end() && i->second->GetLastAccess() == oldestAccess)
+      Delete(shard, i);
   }
-  if (lastAccessed != m_cache.end() && numCached >= max_cached_dirs)
-    Delete(lastAccessed);
 }
 
-void CDirectoryCache::Delete(iCache it)
+void CDirectoryCache::Insert(CShard &shard, const CStdString &storedPath, CDir *dir)
+{
+  iCache i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i);
+
+  dir->SetLastAccess(m_accessCounter);
+  shard.m_cache.insert(pair<CStdString, CDir*>(storedPath, dir));
+  shard.m_size += dir->m_size;
+  AtomicAdd(&m_size, (long)dir->m_size);
+}
+
+void CDirectoryCache::Delete(CShard &shard, iCache it)
 {
   CDir* dir = it->second;
+  shard.m_size -= dir->m_size;
+  AtomicSubtract(&m_size, (long)dir->m_size);
   delete dir;
-  m_cache.erase(it);
+  shard.m_cache.erase(it);
 }
 
-#ifdef _DEBUG
-void CDirectoryCache::PrintStats() const
+void CDirectoryCache::Revalidate(const CStdString &strPath, CDir *dir, int flags)
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
+  // protocols that need user interaction can't be listed in the background
+  if (URIUtils::IsSpecial(strPath) || URIUtils::IsPlugin(strPath))
+    return;
+
+  dir->m_revalidation = AtomicIncrement(&m_revalidations);
+  CJobManager::GetInstance().AddJob(new CDirectoryRevalidateJob(strPath, dir->m_revalidation, flags), NULL);
+}
+
+void CDirectoryCache::RevalidationDone(const CStdString &strPath, long revalidation, const CFileItemList *items, DIR_CACHE_TYPE cacheType)
+{
+  // do the (expensive) copy before taking the lock
+  CDir* dir = NULL;
+  if (items)
   {
-    CDir *dir = i->second;
-    oldest = min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
+    dir = new CDir(cacheType);
+    dir->m_Items->Copy(*items);
+    dir->m_size = EstimateSize(*dir->m_Items);
+  }
+
+  CShard &shard = GetShard(strPath);
+  CSingleLock lock (shard.m_cs);
+
+  // a ClearDirectory(), SetDirectory() or AddFile() happened while listing
+  iCache i = shard.m_cache.find(strPath);
+  if (i == shard.m_cache.end() || i->second->m_revalidation != revalidation)
+  {
+    delete dir;
+    return;
+  }
+
+  if (dir)
+  {
+    Insert(shard, strPath, dir);
+    lock.Leave();
+    CheckIfFull(strPath);
   }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  else
+  { // keep the stale listing and retry once the age has passed again
+    i->second->m_revalidation = 0;
+    i->second->m_cachedTime = XbmcThreads::SystemClockMillis();
+  }
+}
+
+CStdString CDirectoryCache::GetStoredPath(const CStdString &strPath)
+{
+  CStdString storedPath = URIUtils::SubstitutePath(strPath);
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
+}
+
+size_t CDirectoryCache::EstimateSize(const CFileItemList &items)
+{
+  size_t size = sizeof(CFileItemList);
+  for (int i = 0; i < items.Size(); i++)
+    size += EstimateSize(*items[i]);
+  return size;
+}
+
+size_t CDirectoryCache::EstimateSize(const CFileItem &item)
+{
+  // the strings dominate the size of a listed item, tags are rarely filled at this point
+  return sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size() + item.GetLabel2().size();
+}
+
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const CStdString &storedPath)
+{
+  Crc32 crc;
+  crc.Compute(storedPath);
+  return m_shards[(uint32_t)crc % NUM_SHARDS];
+}
+
+const CDirectoryCache::CShard& CDirectoryCache::GetShard(const CStdString &storedPath) const
+{
+  Crc32 crc;
+  crc.Compute(storedPath);
+  return m_shards[(uint32_t)crc % NUM_SHARDS];
+}
+
+#ifdef _DEBUG
+void CDirectoryCache::PrintStats() const
+{
+  Statistics stats;
+  GetStatistics(stats);
+  CLog::Log(LOGDEBUG, "%s - total of %"PRIu64" cache hits, and %"PRIu64" cache misses", __FUNCTION__, stats.hits, stats.misses);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total using %"PRIu64" of %"PRIu64" bytes", __FUNCTION__, stats.directories, stats.items, stats.bytes, stats.maxBytes);
 }
 #endif
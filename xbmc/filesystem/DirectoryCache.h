@@ -25,11 +25,22 @@
 
 #include <map>
 #include <set>
+#include <stdint.h>
 
 class CFileItem;
 
 namespace XFILE
 {
+  /*!
+   \brief Memory bounded cache of directory listings.
+
+   Listings are spread over a number of shards (by hash of their path) that
+   are locked independently, so that a scanner filling the cache doesn't stall
+   the GUI browsing other paths. The memory budget is shared by all shards. When
+   a listing pushes the cache over it, the least recently used listings of all
+   shards are evicted. Listings older than the revalidation age are still served
+   but get refreshed in the background.
+   */
   class CDirectoryCache
   {
     class CDir
@@ -38,18 +49,48 @@ namespace XFILE
       CDir(DIR_CACHE_TYPE cacheType);
       virtual ~CDir();
 
-      void SetLastAccess(unsigned int &accessCounter);
+      void SetLastAccess(volatile long &accessCounter);
       unsigned int GetLastAccess() const { return m_lastAccess; };
+      bool IsExpired(unsigned int now) const;
 
       CFileItemList* m_Items;
       DIR_CACHE_TYPE m_cacheType;
+      size_t m_size;             ///< estimated memory used by m_Items
+      unsigned int m_cachedTime; ///< time the listing was cached
+      long m_revalidation;       ///< id of the pending background refresh, 0 if none
     private:
       unsigned int m_lastAccess;
     };
+
+    typedef std::map<CStdString, CDir*> DirMap;
+    typedef DirMap::iterator iCache;
+    typedef DirMap::const_iterator ciCache;
+
+    class CShard
+    {
+    public:
+      CShard() : m_size(0), m_hits(0), m_misses(0) {}
+
+      CCriticalSection m_cs;
+      DirMap m_cache;
+      size_t m_size;
+      uint64_t m_hits;
+      uint64_t m_misses;
+    };
   public:
+    typedef struct Statistics
+    {
+      uint64_t hits;
+      uint64_t misses;
+      uint64_t bytes;
+      uint64_t maxBytes;
+      unsigned int directories;
+      unsigned int items;
+    } Statistics;
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
-    bool GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll = false);
+    bool GetDirectory(const CStdString& strPath, CFileItemList &items, bool retrieveAll = false, int flags = DIR_FLAG_DEFAULTS);
     void SetDirectory(const CStdString& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
     void ClearDirectory(const CStdString& strPath);
     void ClearFile(const CStdString& strFile);
@@ -57,27 +98,45 @@ namespace XFILE
     void Clear();
     void AddFile(const CStdString& strFile);
     bool FileExists(const CStdString& strPath, bool& bInCache);
+    void GetStatistics(Statistics &stats) const;
 #ifdef _DEBUG
     void PrintStats() const;
 #endif
   protected:
     void InitCache(std::set<CStdString>& dirs);
     void ClearCache(std::set<CStdString>& dirs);
-    void CheckIfFull();
+    /*! \brief Evict the least recently used listings of all shards until the cache fits its budget.
+     Must be called without holding the lock of any shard.
+     \param keepPath the stored path of a listing that was just added and is kept in any case.
+     */
+    void CheckIfFull(const CStdString &keepPath);
+    void Insert(CShard &shard, const CStdString &storedPath, CDir *dir);
+    void Delete(CShard &shard, iCache i);
+    void Revalidate(const CStdString &strPath, CDir *dir, int flags);
 
-    std::map<CStdString, CDir*> m_cache;
-    typedef std::map<CStdString, CDir*>::iterator iCache;
-    typedef std::map<CStdString, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    /*! \brief Store the result of a background refresh.
+     The result is dropped if the listing was cleared, replaced or changed since the
+     refresh started, as it may then be older than what the cache knows.
+     \param strPath the stored path of the listing.
+     \param revalidation the id of the refresh.
+     \param items the refreshed listing, NULL if it couldn't be fetched.
+     \param cacheType the cache type of the directory.
+     */
+    void RevalidationDone(const CStdString &strPath, long revalidation, const CFileItemList *items, DIR_CACHE_TYPE cacheType);
 
-    CCriticalSection m_cs;
+    static CStdString GetStoredPath(const CStdString &strPath);
+    static size_t EstimateSize(const CFileItemList &items);
+    static size_t EstimateSize(const CFileItem &item);
+    CShard& GetShard(const CStdString &storedPath);
+    const CShard& GetShard(const CStdString &storedPath) const;
 
-    unsigned int m_accessCounter;
+    static const unsigned int NUM_SHARDS = 16;
+    CShard m_shards[NUM_SHARDS];
+    volatile long m_size;          ///< estimated memory used by all shards
+    volatile long m_accessCounter; ///< orders the accesses to listings of all shards
+    volatile long m_revalidations; ///< id of the last background refresh
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    friend class CDirectoryRevalidateJob;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
@@ -56,6 +56,19 @@ bool DllLibCurlGlobal::Load()
     return false;
   }
 
+  /* share dns lookups and ssl sessions between all our handles, so a new */
+  /* connection to a host we already talked to skips the full handshake   */
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    if (share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION) != CURLSHE_OK)
+      CLog::Log(LOGDEBUG, "%s - libcurl can't share ssl sessions", __FUNCTION__);
+  }
+
   /* check idle will clean up the last one */
   g_curlReferences = 2;
 
@@ -70,6 +83,12 @@ void DllLibCurlGlobal::Unload()
     if (!IsLoaded())
       return;
 
+    if (m_share)
+    {
+      share_cleanup(m_share);
+      m_share = NULL;
+    }
+
     // close libcurl
     global_cleanup();
 
@@ -188,6 +207,59 @@ void DllLibCurlGlobal::easy_aquire(const char *protocol, const char *hostname, C
 
 }
 
+void DllLibCurlGlobal::multi_aquire(CURLM** multi_handle)
+{
+  assert(multi_handle != NULL);
+
+  CSingleLock lock(m_critSection);
+
+  /* multi only sessions keep the connections of the transfers run on them */
+  VEC_CURLSESSIONS::iterator it;
+  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  {
+    if( !it->m_busy && it->m_easy == NULL && it->m_multi )
+    {
+      it->m_busy = true;
+      *multi_handle = it->m_multi;
+      return;
+    }
+  }
+
+  SSession session = {};
+  session.m_busy = true;
+
+  /* count up global interface counter */
+  Load();
+
+  session.m_multi = multi_init();
+  *multi_handle = session.m_multi;
+
+  m_sessions.push_back(session);
+
+  CLog::Log(LOGINFO, "%s - Created multi session\n", __FUNCTION__);
+}
+
+void DllLibCurlGlobal::multi_release(CURLM** multi_handle)
+{
+  assert(multi_handle != NULL);
+
+  CSingleLock lock(m_critSection);
+
+  CURLM* multi = *multi_handle;
+  *multi_handle = NULL;
+
+  VEC_CURLSESSIONS::iterator it;
+  for(it = m_sessions.begin(); it != m_sessions.end(); it++)
+  {
+    if( it->m_easy == NULL && it->m_multi == multi )
+    {
+      it->m_busy = false;
+      it->m_idletimestamp = XbmcThreads::SystemClockMillis();
+      return;
+    }
+  }
+}
+
 void DllLibCurlGlobal::easy_release(CURL_HANDLE** easy_handle, CURLM** multi_handle)
 {
   CSingleLock lock(m_critSection);
@@ -274,3 +346,13 @@ void DllLibCurlGlobal::easy_duplicate(CURL_HANDLE* easy, CURLM* multi, CURL_HAND
   }
   return;
 }
+
+void DllLibCurlGlobal::share_lock(CURL_HANDLE *handle, curl_lock_data data, curl_lock_access access, void *userptr)
+{
+  ((DllLibCurlGlobal*)userptr)->m_shareSection.lock();
+}
+
+void DllLibCurlGlobal::share_unlock(CURL_HANDLE *handle, curl_lock_data data, void *userptr)
+{
+  ((DllLibCurlGlobal*)userptr)->m_shareSection.unlock();
+}
@@ -53,6 +53,9 @@ namespace XCURL
     virtual void multi_cleanup(CURL_HANDLE * handle )=0;
     virtual struct curl_slist* slist_append(struct curl_slist *, const char *)=0;
     virtual void  slist_free_all(struct curl_slist *)=0;
+    virtual CURLSH * share_init(void)=0;
+    //virtual CURLSHcode share_setopt(CURLSH *share, CURLSHoption option, ...)=0;
+    virtual CURLSHcode share_cleanup(CURLSH *share)=0;
   };
 
   class DllLibCurl : public DllDynamic, DllLibCurlInterface
@@ -78,6 +81,9 @@ namespace XCURL
     DEFINE_METHOD1(void, multi_cleanup, (CURLM *p1))
     DEFINE_METHOD2(struct curl_slist*, slist_append, (struct curl_slist * p1, const char * p2))
     DEFINE_METHOD1(void, slist_free_all, (struct curl_slist * p1))
+    DEFINE_METHOD0(CURLSH *, share_init)
+    DEFINE_METHOD_FP(CURLSHcode, share_setopt, (CURLSH *p1, CURLSHoption p2, ...))
+    DEFINE_METHOD1(CURLSHcode, share_cleanup, (CURLSH *p1))
     BEGIN_METHOD_RESOLVE()
       RESOLVE_METHOD_RENAME(curl_global_init, global_init)
       RESOLVE_METHOD_RENAME(curl_global_cleanup, global_cleanup)
@@ -99,6 +105,9 @@ namespace XCURL
       RESOLVE_METHOD_RENAME(curl_multi_cleanup, multi_cleanup)
       RESOLVE_METHOD_RENAME(curl_slist_append, slist_append)
       RESOLVE_METHOD_RENAME(curl_slist_free_all, slist_free_all)
+      RESOLVE_METHOD_RENAME(curl_share_init, share_init)
+      RESOLVE_METHOD_RENAME_FP(curl_share_setopt, share_setopt)
+      RESOLVE_METHOD_RENAME(curl_share_cleanup, share_cleanup)
     END_METHOD_RESOLVE()
 
   };
@@ -113,6 +122,13 @@ namespace XCURL
     CURL_HANDLE* easy_duphandle(CURL_HANDLE* easy_handle);
     void CheckIdle();
 
+    /* multi handle not tied to a host, used to run several transfers at once */
+    void multi_aquire(CURLM** multi_handle);
+    void multi_release(CURLM** multi_handle);
+
+    /* dns cache and ssl sessions shared by all handles, NULL if unavailable */
+    CURLSH* GetShare() const { return m_share; }
+
     /* overloaded load and unload with reference counter */
     virtual bool Load();
     virtual void Unload();
@@ -132,6 +148,13 @@ namespace XCURL
 
     VEC_CURLSESSIONS m_sessions;
     CCriticalSection m_critSection;
+
+  protected:
+    static void share_lock(CURL_HANDLE *handle, curl_lock_data data, curl_lock_access access, void *userptr);
+    static void share_unlock(CURL_HANDLE *handle, curl_lock_data data, void *userptr);
+
+    CURLSH*          m_share;
+    CCriticalSection m_shareSection;
   };
 }
 
@@ -24,6 +24,8 @@
 #include "utils/CharsetConverter.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+
 using namespace std;
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -392,14 +394,42 @@ void CGUIListItem::SetInvalid()
   if (m_focusedLayout) m_focusedLayout->SetInvalid();
 }
 
+struct PropertyKeyLess
+{
+  bool operator()(const std::pair<CStdString, CVariant> &property, const CStdString &key) const
+  {
+    return property.first.CompareNoCase(key) < 0;
+  }
+};
+
+CGUIListItem::PropertyMap::iterator CGUIListItem::FindProperty(const CStdString &strKey)
+{
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter != m_mapProperties.end() && iter->first.CompareNoCase(strKey) == 0)
+    return iter;
+  return m_mapProperties.end();
+}
+
+CGUIListItem::PropertyMap::const_iterator CGUIListItem::FindProperty(const CStdString &strKey) const
+{
+  PropertyMap::const_iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter != m_mapProperties.end() && iter->first.CompareNoCase(strKey) == 0)
+    return iter;
+  return m_mapProperties.end();
+}
+
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
-  m_mapProperties[strKey] = value;
+  PropertyMap::iterator iter = std::lower_bound(m_mapProperties.begin(), m_mapProperties.end(), strKey, PropertyKeyLess());
+  if (iter != m_mapProperties.end() && iter->first.CompareNoCase(strKey) == 0)
+    iter->second = value;
+  else
+    m_mapProperties.insert(iter, make_pair(strKey, value));
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   if (iter == m_mapProperties.end())
     return CVariant(CVariant::VariantTypeNull);
 
@@ -408,16 +438,21 @@ CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
 
 bool CGUIListItem::HasProperty(const CStdString &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::const_iterator iter = FindProperty(strKey);
   if (iter == m_mapProperties.end())
     return false;
 
   return true;
 }
 
+bool CGUIListItem::HasProperties() const
+{
+  return !m_mapProperties.empty();
+}
+
 void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
+  PropertyMap::iterator iter = FindProperty(strKey);
   if (iter != m_mapProperties.end())
     m_mapProperties.erase(iter);
 }
@@ -32,6 +32,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 //  Forward
 class CGUIListItemLayout;
@@ -169,7 +170,7 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const CStdString &strKey) const;
-  bool       HasProperties() const { return m_mapProperties.size() > 0; };
+  bool       HasProperties() const;
   void       ClearProperty(const CStdString &strKey);
 
   CVariant   GetProperty(const CStdString &strKey) const;
@@ -183,17 +184,15 @@ protected:
   CGUIListItemLayout *m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const CStdString &s1, const CStdString &s2) const
-    {
-      return s1.CompareNoCase(s2) < 0;
-    }
-  };
-
-  typedef std::map<CStdString, CVariant, icompare> PropertyMap;
+  /* Properties are kept in a vector sorted case insensitively on the key. An item
+     rarely has more than a handful of properties, so this is much smaller than a
+     map with a node per property and just as quick to search. */
+  typedef std::vector< std::pair<CStdString, CVariant> > PropertyMap;
   PropertyMap m_mapProperties;
 private:
+  PropertyMap::iterator FindProperty(const CStdString &strKey);
+  PropertyMap::const_iterator FindProperty(const CStdString &strKey) const;
+
   CStdStringW m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   CStdString m_strLabel;      // text of column1
 
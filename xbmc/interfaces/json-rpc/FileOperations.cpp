@@ -24,6 +24,7 @@
 #include "settings/Settings.h"
 #include "MediaSource.h"
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/File.h"
 #include "FileItem.h"
 #include "settings/AdvancedSettings.h"
@@ -216,6 +217,21 @@ JSONRPC_STATUS CFileOperations::GetFileDetails(const CStdString &method, ITransp
   return OK;
 }
 
+JSONRPC_STATUS CFileOperations::GetDirectoryCacheStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  CDirectoryCache::Statistics stats;
+  g_directoryCache.GetStatistics(stats);
+
+  result["hits"] = stats.hits;
+  result["misses"] = stats.misses;
+  result["bytes"] = stats.bytes;
+  result["maxbytes"] = stats.maxBytes;
+  result["directories"] = stats.directories;
+  result["items"] = stats.items;
+
+  return OK;
+}
+
 JSONRPC_STATUS CFileOperations::PrepareDownload(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   std::string protocol;
@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://www.xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.1.0";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.2.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -1818,6 +1818,24 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Files.GetDirectoryCacheStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves statistics about the cache of directory listings\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": [],"
+      "\"returns\": {"
+        "\"type\": \"object\","
+        "\"properties\": {"
+          "\"hits\": { \"type\": \"integer\", \"required\": true },"
+          "\"misses\": { \"type\": \"integer\", \"required\": true },"
+          "\"bytes\": { \"type\": \"integer\", \"required\": true, \"description\": \"Estimated memory used by the cached listings\" },"
+          "\"maxbytes\": { \"type\": \"integer\", \"required\": true },"
+          "\"directories\": { \"type\": \"integer\", \"required\": true },"
+          "\"items\": { \"type\": \"integer\", \"required\": true }"
+        "}"
+      "}"
+    "}",
     "\"AudioLibrary.GetArtists\": {"
       "\"type\": \"method\","
       "\"description\": \"Retrieve all artists\","
@@ -55,6 +55,7 @@
 #include "utils/StringUtils.h"
 #include "guilib/LocalizeStrings.h"
 #include "utils/log.h"
+#include "utils/DirectoryHashTree.h"
 #include "utils/TimeUtils.h"
 #include "TextureCache.h"
 #include "addons/AddonInstaller.h"
@@ -4124,6 +4125,32 @@ bool CMusicDatabase::GetPathHash(const CStdString &path, CStdString &hash)
   return false;
 }
 
+bool CMusicDatabase::GetPathHashes(CDirectoryHashTree &tree)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // paths without a hash were never scanned completely, keep them so their parents get listed
+    CStdString strSQL = "select strPath, strHash from path";
+    m_pDS->query(strSQL.c_str());
+    while (!m_pDS->eof())
+    {
+      tree.Add(m_pDS->fv(0).get_asString(), m_pDS->fv(1).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+
+  return false;
+}
+
 bool CMusicDatabase::RemoveSongsFromPath(const CStdString &path1, CSongMap &songs, bool exact)
 {
   // We need to remove all songs from this path, as their tags are going
@@ -5249,6 +5276,81 @@ string CMusicDatabase::GetArtForItem(int mediaId, const string &mediaType, const
   return GetSingleValue(query, m_pDS2);
 }
 
+bool CMusicDatabase::GetArtForItems(const vector<int> &mediaIds, const string &mediaType, map<int, map<string, string> > &art)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
+
+    static const size_t chunkSize = 500;
+    for (size_t start = 0; start < mediaIds.size(); start += chunkSize)
+    {
+      CStdString ids;
+      for (size_t i = start; i < mediaIds.size() && i < start + chunkSize; i++)
+      {
+        ids.AppendFormat("%i,", mediaIds[i]);
+        art[mediaIds[i]];
+      }
+      ids.TrimRight(",");
+
+      CStdString sql = PrepareSQL("SELECT media_id,type,url FROM art WHERE media_type='%s' AND media_id IN (%s)", mediaType.c_str(), ids.c_str());
+      m_pDS2->query(sql.c_str());
+      while (!m_pDS2->eof())
+      {
+        art[m_pDS2->fv(0).get_asInt()].insert(make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
+bool CMusicDatabase::GetArtistArtForItems(const vector<int> &mediaIds, const string &mediaType, map<int, map<string, string> > &art)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
+
+    static const size_t chunkSize = 500;
+    for (size_t start = 0; start < mediaIds.size(); start += chunkSize)
+    {
+      CStdString ids;
+      for (size_t i = start; i < mediaIds.size() && i < start + chunkSize; i++)
+      {
+        ids.AppendFormat("%i,", mediaIds[i]);
+        art[mediaIds[i]];
+      }
+      ids.TrimRight(",");
+
+      CStdString sql = PrepareSQL("SELECT %s_artist.id%s,art.type,art.url FROM %s_artist JOIN art ON art.media_id=%s_artist.idArtist AND art.media_type='artist' "
+                                  "WHERE %s_artist.iOrder=0 AND %s_artist.id%s IN (%s)",
+                                  mediaType.c_str(), mediaType.c_str(), mediaType.c_str(), mediaType.c_str(),
+                                  mediaType.c_str(), mediaType.c_str(), mediaType.c_str(), ids.c_str());
+      m_pDS2->query(sql.c_str());
+      while (!m_pDS2->eof())
+      {
+        art[m_pDS2->fv(0).get_asInt()].insert(make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
 bool CMusicDatabase::GetArtistArtForItem(int mediaId, const std::string &mediaType, std::map<std::string, std::string> &art)
 {
   try
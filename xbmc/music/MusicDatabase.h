@@ -70,6 +70,7 @@ typedef std::set<CStdString>::iterator ISETPATHES;
 
 class CGUIDialogProgress;
 class CFileItemList;
+class CDirectoryHashTree;
 
 /*!
  \ingroup music
@@ -153,6 +154,7 @@ public:
   bool GetPaths(std::set<CStdString> &paths);
   bool SetPathHash(const CStdString &path, const CStdString &hash);
   bool GetPathHash(const CStdString &path, CStdString &hash);
+  bool GetPathHashes(CDirectoryHashTree &tree);
   bool GetGenresNav(const CStdString& strBaseDir, CFileItemList& items, const Filter &filter = Filter(), bool countOnly = false);
   bool GetYearsNav(const CStdString& strBaseDir, CFileItemList& items);
   bool GetArtistsNav(const CStdString& strBaseDir, CFileItemList& items, bool albumArtistsOnly = false, int idGenre = -1, int idAlbum = -1, int idSong = -1, const Filter &filter = Filter(), const SortDescription &sortDescription = SortDescription(), bool countOnly = false);
@@ -251,6 +253,15 @@ public:
    */
   std::string GetArtForItem(int mediaId, const std::string &mediaType, const std::string &artType);
 
+  /*! \brief Fetch art for several database items of the same type at once.
+   \param mediaIds the ids in the media (song/artist/album) table.
+   \param mediaType the type of media, which corresponds to the table the items reside in (song/artist/album).
+   \param art [out] a map of media id to the <type, url> art map of that item. Items without art get an empty map.
+   \return true if the art could be retrieved, false on error.
+   \sa GetArtForItem
+   */
+  bool GetArtForItems(const std::vector<int> &mediaIds, const std::string &mediaType, std::map<int, std::map<std::string, std::string> > &art);
+
   /*! \brief Fetch artist art for a song or album item.
    Fetches the art associated with the primary artist for the song or album.
    \param mediaId the id in the media (song/album) table.
@@ -271,6 +282,15 @@ public:
    */
   std::string GetArtistArtForItem(int mediaId, const std::string &mediaType, const std::string &artType);
 
+  /*! \brief Fetch artist art for several song or album items at once.
+   \param mediaIds the ids in the media (song/album) table.
+   \param mediaType the type of media, which corresponds to the table the items reside in (song/album).
+   \param art [out] a map of media id to the <type, url> art map of its primary artist. Items without artist art get an empty map.
+   \return true if the art could be retrieved, false on error.
+   \sa GetArtistArtForItem
+   */
+  bool GetArtistArtForItems(const std::vector<int> &mediaIds, const std::string &mediaType, std::map<int, std::map<std::string, std::string> > &art);
+
   virtual bool GetFilter(CDbUrl &musicUrl, Filter &filter, SortDescription &sorting);
 
 protected:
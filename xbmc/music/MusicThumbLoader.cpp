@@ -55,11 +55,68 @@ void CMusicThumbLoader::Deinitialize()
 void CMusicThumbLoader::OnLoaderStart()
 {
   Initialize();
+  FetchLibraryArt();
 }
 
 void CMusicThumbLoader::OnLoaderFinish()
 {
   Deinitialize();
+  m_libraryArt.clear();
+  m_artistArt.clear();
+}
+
+void CMusicThumbLoader::FetchLibraryArt()
+{
+  m_libraryArt.clear();
+  m_artistArt.clear();
+
+  // collect the items that will end up in FillLibraryArt()
+  map<string, vector<int> > ids;
+  vector<int> albumIds;
+  for (vector<CFileItemPtr>::const_iterator i = m_vecItems.begin(); i != m_vecItems.end(); ++i)
+  {
+    const CFileItemPtr &item = *i;
+    if (!item->HasMusicInfoTag() || !item->GetArt().empty())
+      continue;
+    const CMusicInfoTag *tag = item->GetMusicInfoTag();
+    if (tag->GetDatabaseId() > -1 && !tag->GetType().empty())
+    {
+      ids[tag->GetType()].push_back(tag->GetDatabaseId());
+      if (tag->GetType() == "song" && m_albumArt.find(tag->GetAlbumId()) == m_albumArt.end())
+      {
+        m_albumArt[tag->GetAlbumId()];
+        albumIds.push_back(tag->GetAlbumId());
+      }
+    }
+  }
+  if (ids.empty())
+    return;
+
+  for (map<string, vector<int> >::const_iterator i = ids.begin(); i != ids.end(); ++i)
+  {
+    if (!m_database->GetArtForItems(i->second, i->first, m_libraryArt[i->first]))
+      m_libraryArt.erase(i->first);
+    if ((i->first == "song" || i->first == "album") &&
+        !m_database->GetArtistArtForItems(i->second, i->first, m_artistArt[i->first]))
+      m_artistArt.erase(i->first);
+  }
+  if (!albumIds.empty() && !m_database->GetArtForItems(albumIds, "album", m_albumArt))
+  {
+    for (vector<int>::const_iterator i = albumIds.begin(); i != albumIds.end(); ++i)
+      m_albumArt.erase(*i);
+  }
+}
+
+const map<string, string> *CMusicThumbLoader::FindArt(const map<string, ArtCache> &cache, int dbId, const string &type)
+{
+  map<string, ArtCache>::const_iterator i = cache.find(type);
+  if (i != cache.end())
+  {
+    ArtCache::const_iterator j = i->second.find(dbId);
+    if (j != i->second.end())
+      return &j->second;
+  }
+  return NULL;
 }
 
 bool CMusicThumbLoader::LoadItem(CFileItem* pItem)
@@ -147,8 +204,9 @@ bool CMusicThumbLoader::FillLibraryArt(CFileItem &item)
   {
     m_database->Open();
     map<string, string> artwork;
-    if (m_database->GetArtForItem(tag.GetDatabaseId(), tag.GetType(), artwork))
-      item.SetArt(artwork);
+    const map<string, string> *fetched = FindArt(m_libraryArt, tag.GetDatabaseId(), tag.GetType());
+    if (fetched ? !fetched->empty() : m_database->GetArtForItem(tag.GetDatabaseId(), tag.GetType(), artwork))
+      item.SetArt(fetched ? *fetched : artwork);
     else if (tag.GetType() == "song")
     { // no art for the song, try the album
       ArtCache::const_iterator i = m_albumArt.find(tag.GetAlbumId());
@@ -166,7 +224,16 @@ bool CMusicThumbLoader::FillLibraryArt(CFileItem &item)
     }
     if (tag.GetType() == "song" || tag.GetType() == "album")
     { // fanart from the artist
-      string fanart = m_database->GetArtistArtForItem(tag.GetDatabaseId(), tag.GetType(), "fanart");
+      string fanart;
+      const map<string, string> *artistArt = FindArt(m_artistArt, tag.GetDatabaseId(), tag.GetType());
+      if (artistArt)
+      {
+        map<string, string>::const_iterator i = artistArt->find("fanart");
+        if (i != artistArt->end())
+          fanart = i->second;
+      }
+      else
+        fanart = m_database->GetArtistArtForItem(tag.GetDatabaseId(), tag.GetType(), "fanart");
       if (!fanart.empty())
       {
         item.SetArt("artist.fanart", fanart);
@@ -60,8 +60,22 @@ public:
 protected:
   virtual void OnLoaderStart();
   virtual void OnLoaderFinish();
+
+  typedef std::map<int, std::map<std::string, std::string> > ArtCache;
+
+  /*! \brief fetch the library art of all items being loaded with one query per media type
+   \sa FillLibraryArt
+   */
+  void FetchLibraryArt();
+
+  /*! \brief find the fetched art of a library item
+   \param cache the fetched art, by media type
+   \return the art of the item, NULL if it wasn't fetched
+   */
+  static const std::map<std::string, std::string> *FindArt(const std::map<std::string, ArtCache> &cache, int dbId, const std::string &type);
   
   CMusicDatabase *m_database;
-  typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_albumArt;
+  std::map<std::string, ArtCache> m_libraryArt; ///< art of the items being loaded, by media type
+  std::map<std::string, ArtCache> m_artistArt;  ///< art of the primary artist of the songs/albums being loaded
 };
@@ -51,6 +51,7 @@
 #include "music/MusicThumbLoader.h"
 #include "interfaces/AnnouncementManager.h"
 #include "GUIUserMessages.h"
+#include "threads/SingleLock.h"
 
 #include <algorithm>
 
@@ -59,6 +60,44 @@ using namespace MUSIC_INFO;
 using namespace XFILE;
 using namespace MUSIC_GRABBER;
 
+/*! \brief Reads the tags of a list of items from several threads.
+ Each thread picks the next unread item, so a slow file on a network share
+ doesn't hold up the reads behind it.
+ */
+class CMusicTagReader : public IRunnable
+{
+public:
+  CMusicTagReader(const vector<CFileItemPtr> &items, const volatile bool &stop)
+    : m_items(items), m_stop(stop), m_next(0)
+  {
+  }
+
+  virtual void Run()
+  {
+    while (!m_stop)
+    {
+      CFileItemPtr item;
+      {
+        CSingleLock lock(m_section);
+        if (m_next >= m_items.size())
+          break;
+        item = m_items[m_next++];
+      }
+
+      CMusicInfoTag& tag = *item->GetMusicInfoTag();
+      auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(item->GetPath()));
+      if (NULL != pLoader.get())
+        pLoader->Load(item->GetPath(), tag);
+    }
+  }
+
+private:
+  const vector<CFileItemPtr> &m_items;
+  const volatile bool &m_stop;
+  CCriticalSection m_section;
+  unsigned int m_next;
+};
+
 CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner")
 {
   m_bRunning = false;
@@ -68,6 +107,7 @@ CMusicInfoScanner::CMusicInfoScanner() : CThread("CMusicInfoScanner")
   m_currentItem=0;
   m_itemCount=0;
   m_flags = 0;
+  ResetStats();
 }
 
 CMusicInfoScanner::~CMusicInfoScanner()
@@ -83,6 +123,11 @@ void CMusicInfoScanner::Process()
 
     m_musicDatabase.Open();
 
+    // directories seen by earlier scans, so that unchanged ones needn't be listed
+    m_pathTree.Clear();
+    if (g_advancedSettings.m_bMusicLibraryFastHash)
+      m_musicDatabase.GetPathHashes(m_pathTree);
+
     if (m_showDialog && !g_guiSettings.GetBool("musiclibrary.backgroundupdate"))
     {
       CGUIDialogExtendedProgressBar* dialog =
@@ -102,6 +147,7 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      ResetStats();
 
       // Create the thread to count all files to be scanned
       SetPriority( GetMinPriority() );
@@ -161,6 +207,7 @@ void CMusicInfoScanner::Process()
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      LogStats();
     }
     bool bCanceled;
     if (m_scanType == 1) // load album info
@@ -390,9 +437,37 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
   if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
     return true;
 
+  // with fast hashing a directory whose entries haven't changed since the last scan isn't
+  // listed, we only descend into the subfolders we know of
+  CStdString fastHash;
+  if (g_advancedSettings.m_bMusicLibraryFastHash)
+  {
+    fastHash = GetFastHash(strDirectory);
+    CStdString dbHash;
+    vector<string> subdirs;
+    if (!(m_flags & SCAN_RESCAN) && !fastHash.IsEmpty() &&
+        m_musicDatabase.GetPathHash(strDirectory, dbHash) && dbHash == fastHash &&
+        m_pathTree.GetSubDirectories(strDirectory, "fast", subdirs))
+    {
+      CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change (fasthash)", __FUNCTION__, strDirectory.c_str());
+      if (m_handle)
+        OnDirectoryScanned(strDirectory);
+
+      for (vector<string>::const_iterator it = subdirs.begin(); it != subdirs.end() && !m_bStop; ++it)
+      {
+        if (!DoScan(*it))
+          m_bStop = true;
+      }
+      return !m_bStop;
+    }
+  }
+
   // load subfolder
+  unsigned int start = XbmcThreads::SystemClockMillis();
   CFileItemList items;
   CDirectory::GetDirectory(strDirectory, items, g_settings.m_musicExtensions + "|.jpg|.tbn|.lrc|.cdg");
+  m_stats.directories++;
+  m_stats.directoryTime += XbmcThreads::SystemClockMillis() - start;
 
   // sort and get the path hash.  Note that we don't filter .cue sheet items here as we want
   // to detect changes in the .cue sheet as well.  The .cue sheet items only need filtering
@@ -422,13 +497,17 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     }
 
     // save information about this folder
-    m_musicDatabase.SetPathHash(strDirectory, hash);
+    m_musicDatabase.SetPathHash(strDirectory, fastHash.IsEmpty() ? hash : fastHash);
   }
   else
   { // path is the same - no need to rescan
     CLog::Log(LOGDEBUG, "%s Skipping dir '%s' due to no change", __FUNCTION__, strDirectory.c_str());
     m_currentItem += CountFiles(items, false);  // false for non-recursive
 
+    // switch to the fast hash so the next scan needn't list this folder
+    if (!fastHash.IsEmpty())
+      m_musicDatabase.SetPathHash(strDirectory, fastHash);
+
     // updated the dialog with our progress
     if (m_handle)
     {
@@ -456,6 +535,26 @@ bool CMusicInfoScanner::DoScan(const CStdString& strDirectory)
     }
   }
 
+  // the next scan only descends into the subfolders stored with a fast hash, so keep the full
+  // hash while any subfolder (eg an excluded one) has none, and this folder gets listed again
+  if (!fastHash.IsEmpty())
+  {
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      CStdString subHash;
+      if (!m_musicDatabase.GetPathHash(pItem->GetPath(), subHash) || !StringUtils::StartsWith(subHash, "fast"))
+      {
+        CLog::Log(LOGDEBUG, "%s Not fast hashing dir '%s' as not all its subfolders are", __FUNCTION__, strDirectory.c_str());
+        m_musicDatabase.SetPathHash(strDirectory, hash);
+        break;
+      }
+    }
+  }
+
   return !m_bStop;
 }
 
@@ -471,6 +570,22 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
 
   CStdStringArray regexps = g_advancedSettings.m_audioExcludeFromScanRegExps;
 
+  // read the tags we can up front from several threads, the rest are read below
+  unsigned int start = XbmcThreads::SystemClockMillis();
+  vector<CFileItemPtr> concurrent;
+  for (int i = 0; i < items.Size(); ++i)
+  {
+    CFileItemPtr pItem = items[i];
+    if (IsSongItem(*pItem) && !pItem->GetMusicInfoTag()->Loaded() &&
+        !CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps) &&
+        CMusicInfoTagLoaderFactory::SupportsConcurrentLoad(pItem->GetPath()))
+      concurrent.push_back(pItem);
+  }
+  ReadTags(concurrent);
+  set<CFileItem*> tagsRead;
+  for (vector<CFileItemPtr>::iterator it = concurrent.begin(); it != concurrent.end(); ++it)
+    tagsRead.insert(it->get());
+
   // for every file found, but skip folder
   for (int i = 0; i < items.Size(); ++i)
   {
@@ -486,7 +601,7 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
       continue;
 
     // dont try reading id3tags for folders, playlists or shoutcast streams
-    if (!pItem->m_bIsFolder && !pItem->IsPlayList() && !pItem->IsPicture() && !pItem->IsLyrics() )
+    if (IsSongItem(*pItem))
     {
       m_currentItem++;
 //      CLog::Log(LOGDEBUG, "%s - Reading tag for: %s", __FUNCTION__, pItem->GetPath().c_str());
@@ -495,8 +610,9 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
       CSong *dbSong = songsMap.Find(pItem->GetPath());
 
       CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-      if (!tag.Loaded() )
+      if (!tag.Loaded() && tagsRead.find(pItem.get()) == tagsRead.end())
       { // read the tag from a file
+        m_stats.tags++;
         auto_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(pItem->GetPath()));
         if (NULL != pLoader.get())
           pLoader->Load(pItem->GetPath(), tag);
@@ -547,11 +663,16 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
     }
   }
 
+  m_stats.tagTime += XbmcThreads::SystemClockMillis() - start;
+
+  start = XbmcThreads::SystemClockMillis();
   VECALBUMS albums;
   CategoriseAlbums(songsToAdd, albums);
   FindArtForAlbums(albums, items.GetPath());
+  m_stats.categoriseTime += XbmcThreads::SystemClockMillis() - start;
 
   // finally, add these to the database
+  start = XbmcThreads::SystemClockMillis();
   m_musicDatabase.BeginTransaction();
   int numAdded = 0;
   set<int> albumsToScan;
@@ -580,6 +701,8 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
     artistsToScan.insert(albumArtists.begin(), albumArtists.end());
   }
   m_musicDatabase.CommitTransaction();
+  m_stats.songs += numAdded;
+  m_stats.databaseTime += XbmcThreads::SystemClockMillis() - start;
 
   // Download info & artwork
   bool bCanceled;
@@ -633,6 +756,62 @@ int CMusicInfoScanner::RetrieveMusicInfo(CFileItemList& items, const CStdString&
   return songsToAdd.size();
 }
 
+bool CMusicInfoScanner::IsSongItem(const CFileItem &item)
+{
+  return !item.m_bIsFolder && !item.IsPlayList() && !item.IsPicture() && !item.IsLyrics();
+}
+
+void CMusicInfoScanner::ReadTags(const vector<CFileItemPtr> &items)
+{
+  if (items.empty())
+    return;
+
+  unsigned int threads = std::min((unsigned int)g_advancedSettings.m_musicTagReadThreads, (unsigned int)items.size());
+  CMusicTagReader reader(items, m_bStop);
+  if (threads > 1)
+  {
+    vector<CThread*> workers;
+    for (unsigned int i = 1; i < threads; i++)
+    {
+      CThread *worker = new CThread(&reader, "CMusicTagReader");
+      worker->Create();
+      workers.push_back(worker);
+    }
+    // this thread reads too, then waits for the others to finish their current file
+    reader.Run();
+    for (vector<CThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+    {
+      (*it)->StopThread();
+      delete *it;
+    }
+  }
+  else
+    reader.Run();
+
+  m_stats.tags += items.size();
+}
+
+void CMusicInfoScanner::ResetStats()
+{
+  m_stats.directories = 0;
+  m_stats.tags = 0;
+  m_stats.songs = 0;
+  m_stats.directoryTime = 0;
+  m_stats.tagTime = 0;
+  m_stats.categoriseTime = 0;
+  m_stats.databaseTime = 0;
+}
+
+void CMusicInfoScanner::LogStats() const
+{
+  CLog::Log(LOGDEBUG, "%s - listed %u directories in %ums, read %u tags in %ums (%u threads), "
+            "categorised in %ums, added %u songs to the database in %ums", __FUNCTION__,
+            m_stats.directories, m_stats.directoryTime,
+            m_stats.tags, m_stats.tagTime, (unsigned int)g_advancedSettings.m_musicTagReadThreads,
+            m_stats.categoriseTime,
+            m_stats.songs, m_stats.databaseTime);
+}
+
 static bool SortSongsByTrack(CSong *song, CSong *song2)
 {
   return song->iTrack < song2->iTrack;
@@ -890,6 +1069,24 @@ int CMusicInfoScanner::CountFiles(const CFileItemList &items, bool recursive)
   return count;
 }
 
+CStdString CMusicInfoScanner::GetFastHash(const CStdString &directory) const
+{
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(directory, &buffer) == 0)
+  {
+    int64_t time = buffer.st_mtime;
+    if (!time)
+      time = buffer.st_ctime;
+    if (time)
+    {
+      CStdString hash;
+      hash.Format("fast%"PRId64, time);
+      return hash;
+    }
+  }
+  return "";
+}
+
 int CMusicInfoScanner::GetPathHash(const CFileItemList &items, CStdString &hash)
 {
   // Create a hash based on the filenames, filesize and filedate.  Also count the number of files
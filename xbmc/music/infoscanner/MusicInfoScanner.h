@@ -21,6 +21,8 @@
 #include "threads/Thread.h"
 #include "music/MusicDatabase.h"
 #include "MusicAlbumInfo.h"
+#include "FileItem.h"
+#include "utils/DirectoryHashTree.h"
 
 class CAlbum;
 class CArtist;
@@ -98,10 +100,35 @@ protected:
   virtual void Process();
   int RetrieveMusicInfo(CFileItemList& items, const CStdString& strDirectory);
   int GetPathHash(const CFileItemList &items, CStdString &hash);
+
+  /*! \brief Retrieve a "fast" hash of the given directory (if available)
+   Uses the modified time of the directory, which changes whenever files are added, removed
+   or renamed but not when a file's tags are edited in place, so this is only used if
+   <musiclibrary><fasthash> is enabled.
+   \param directory folder to hash
+   \return the hash of the folder of the form "fast<datetime>", empty if not available
+   */
+  CStdString GetFastHash(const CStdString &directory) const;
   void GetAlbumArtwork(long id, const CAlbum &artist);
 
   bool DoScan(const CStdString& strDirectory);
 
+  /*! \brief Whether this item is a file we should read a song tag from
+   */
+  static bool IsSongItem(const CFileItem &item);
+
+  /*! \brief Read the tags of the given items using up to <tagreadthreads> threads
+   Tag reading is bound by file I/O, so on network shares reading several files at
+   once keeps the pipe full. Items whose loader can't be shared between threads must
+   not be passed in.
+   \param items [in/out] items whose music info tags are loaded.
+   \sa CMusicInfoTagLoaderFactory::SupportsConcurrentLoad
+   */
+  void ReadTags(const std::vector<CFileItemPtr> &items);
+
+  void ResetStats();
+  void LogStats() const;
+
   virtual void Run();
   int CountFiles(const CFileItemList& items, bool recursive);
   int CountFilesRecursively(const CStdString& strPath);
@@ -124,5 +151,19 @@ protected:
   std::vector<long> m_artistsScanned;
   std::vector<long> m_albumsScanned;
   int m_flags;
+  CDirectoryHashTree m_pathTree;
+
+  /*! \brief Counters and time spent (ms) in each stage of a file scan
+   */
+  struct ScanStats
+  {
+    unsigned int directories;
+    unsigned int tags;
+    unsigned int songs;
+    unsigned int directoryTime;
+    unsigned int tagTime;
+    unsigned int categoriseTime;
+    unsigned int databaseTime;
+  } m_stats;
 };
 }
@@ -127,3 +127,26 @@ IMusicInfoTagLoader* CMusicInfoTagLoaderFactory::CreateLoader(const CStdString&
 
   return NULL;
 }
+
+bool CMusicInfoTagLoaderFactory::SupportsConcurrentLoad(const CStdString& strFileName)
+{
+  CFileItem item(strFileName, false);
+  if (item.IsMusicDb() || item.IsCDDA())
+    return false;
+
+  CStdString strExtension;
+  URIUtils::GetExtension(strFileName, strExtension);
+  strExtension.ToLower();
+  strExtension.TrimLeft('.');
+
+  if (strExtension == "spc" || strExtension == "ym" ||
+      strExtension == "nsf" || strExtension == "nsfstream" ||
+      TimidityCodec::IsSupportedFormat(strExtension))
+    return false;
+#ifdef HAS_ASAP_CODEC
+  if (ASAPCodec::IsSupportedFormat(strExtension) || strExtension == "asapstream")
+    return false;
+#endif
+
+  return true;
+}
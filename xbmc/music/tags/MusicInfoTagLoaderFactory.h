@@ -30,6 +30,14 @@ namespace MUSIC_INFO
       virtual ~CMusicInfoTagLoaderFactory();
 
       static IMusicInfoTagLoader* CreateLoader(const CStdString& strFileName);
+
+      /*! \brief Whether the tag of this file may be read while other tags are being read
+       Loaders that go through a codec dll, the optical drive or the music database
+       share state between instances and must only be used from one thread at a time.
+       \param strFileName path of the file to read the tag from.
+       \return true if the loader for this file can run concurrently with other loaders.
+       */
+      static bool SupportsConcurrentLoad(const CStdString& strFileName);
   };
 }
 
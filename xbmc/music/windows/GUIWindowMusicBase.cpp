@@ -1355,6 +1355,11 @@ bool CGUIWindowMusicBase::CanContainFilter(const CStdString &strDirectory) const
   return StringUtils::StartsWith(strDirectory, "musicdb://");
 }
 
+void CGUIWindowMusicBase::OnSelectionChanged(const CFileItemPtr &item)
+{
+  m_musicInfoLoader.PrioritizeItem(item);
+}
+
 void CGUIWindowMusicBase::OnInitWindow()
 {
   CGUIMediaWindow::OnInitWindow();
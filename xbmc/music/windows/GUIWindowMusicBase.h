@@ -53,6 +53,7 @@ public:
 
 protected:
   virtual void OnInitWindow();
+  virtual void OnSelectionChanged(const CFileItemPtr &item);
   /*!
   \brief Will be called when an popup context menu has been asked for
   \param itemNumber List/thumb control item that has been clicked on
@@ -784,6 +784,12 @@ void CGUIWindowMusicNav::OnSearchUpdate()
   }
 }
 
+void CGUIWindowMusicNav::OnSelectionChanged(const CFileItemPtr &item)
+{
+  CGUIWindowMusicBase::OnSelectionChanged(item);
+  m_thumbLoader.PrioritizeItem(item);
+}
+
 void CGUIWindowMusicNav::FrameMove()
 {
   static const int search_timeout = 2000;
@@ -39,6 +39,7 @@ public:
   virtual void OnPrepareFileItems(CFileItemList &items);
 protected:
   virtual void OnItemLoaded(CFileItem* pItem) {};
+  virtual void OnSelectionChanged(const CFileItemPtr &item);
   // override base class methods
   virtual bool Update(const CStdString &strDirectory, bool updateFilterPath = true);
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList &items);
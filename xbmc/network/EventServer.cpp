@@ -35,6 +35,7 @@
 #include "Zeroconf.h"
 #include "guilib/GUIAudioManager.h"
 #include "guilib/Key.h"
+#include "threads/SystemClock.h"
 #include <map>
 #include <queue>
 
@@ -44,6 +45,11 @@ using namespace EVENTCLIENT;
 using namespace SOCKETS;
 using namespace std;
 
+// maximum number of packets read in one go before the clients' events are processed
+#define ES_MAX_PACKETS_PER_BATCH 64
+// interval in ms at which timed out clients are removed
+#define ES_REFRESH_INTERVAL      1000
+
 /************************************************************************/
 /* CEventServer                                                         */
 /************************************************************************/
@@ -55,6 +61,9 @@ CEventServer::CEventServer() : CThread("CEventServer")
   m_bStop         = false;
   m_bRunning      = false;
   m_bRefreshSettings = false;
+  m_iLastRefresh  = 0;
+  m_iLastButtonClient = 0;
+  m_iLastActionClient = 0;
 
   // default timeout in ms for receiving a single packet
   m_iListenTimeout = 1000;
@@ -206,14 +215,17 @@ void CEventServer::Run()
   {
     try
     {
-      // start listening until we timeout
+      // start listening until we timeout, then read everything that queued up in the
+      // meantime so a burst from several clients is handled in a single pass
       if (listener.Listen(m_iListenTimeout))
       {
-        CAddress addr;
-        if ((packetSize = m_pSocket->Read(addr, PACKET_SIZE, (void *)m_pPacketBuffer)) > -1)
+        int iPackets = 0;
+        do
         {
-          ProcessPacket(addr, packetSize);
-        }
+          CAddress addr;
+          if ((packetSize = m_pSocket->Read(addr, PACKET_SIZE, (void *)m_pPacketBuffer)) > -1)
+            ProcessPacket(addr, packetSize);
+        } while (++iPackets < ES_MAX_PACKETS_PER_BATCH && listener.Listen(0));
       }
     }
     catch (...)
@@ -226,7 +238,11 @@ void CEventServer::Run()
     ProcessEvents();
 
     // refresh client list
-    RefreshClients();
+    if (m_bRefreshSettings || XbmcThreads::SystemClockMillis() - m_iLastRefresh >= ES_REFRESH_INTERVAL)
+    {
+      RefreshClients();
+      m_iLastRefresh = XbmcThreads::SystemClockMillis();
+    }
 
     // broadcast
     // BroadcastBeacon();
@@ -317,7 +333,8 @@ void CEventServer::RefreshClients()
 
 void CEventServer::ProcessEvents()
 {
-  CSingleLock lock(m_critSection);
+  // no need to lock, the client list only changes on this thread. the clients lock their own
+  // button and action queues, so the application can keep polling them while packets are parsed
   map<unsigned long, CEventClient*>::iterator iter = m_clients.begin();
 
   while (iter != m_clients.end())
@@ -330,14 +347,22 @@ void CEventServer::ProcessEvents()
 bool CEventServer::ExecuteNextAction()
 {
   CSingleLock lock(m_critSection);
+  if (m_clients.empty())
+    return false;
 
+  // start after the client that sent the last action so a busy client can't starve the others
   CEventAction actionEvent;
-  map<unsigned long, CEventClient*>::iterator iter = m_clients.begin();
+  map<unsigned long, CEventClient*>::iterator start = m_clients.upper_bound(m_iLastActionClient);
+  if (start == m_clients.end())
+    start = m_clients.begin();
+  map<unsigned long, CEventClient*>::iterator iter = start;
 
-  while (iter != m_clients.end())
+  do
   {
     if (iter->second->GetNextAction(actionEvent))
     {
+      m_iLastActionClient = iter->first;
+
       // Leave critical section before processing action
       lock.Leave();
       switch(actionEvent.actionType)
@@ -358,8 +383,10 @@ bool CEventServer::ExecuteNextAction()
       }
       return true;
     }
-    iter++;
-  }
+
+    if (++iter == m_clients.end())
+      iter = m_clients.begin();
+  } while (iter != start);
 
   return false;
 }
@@ -367,16 +394,29 @@ bool CEventServer::ExecuteNextAction()
 unsigned int CEventServer::GetButtonCode(std::string& strMapName, bool& isAxis, float& fAmount)
 {
   CSingleLock lock(m_critSection);
-  map<unsigned long, CEventClient*>::iterator iter = m_clients.begin();
   unsigned int bcode = 0;
+  if (m_clients.empty())
+    return bcode;
 
-  while (iter != m_clients.end())
+  // start after the client that sent the last button, same as ExecuteNextAction()
+  map<unsigned long, CEventClient*>::iterator start = m_clients.upper_bound(m_iLastButtonClient);
+  if (start == m_clients.end())
+    start = m_clients.begin();
+  map<unsigned long, CEventClient*>::iterator iter = start;
+
+  do
   {
     bcode = iter->second->GetButtonCode(strMapName, isAxis, fAmount);
     if (bcode)
+    {
+      m_iLastButtonClient = iter->first;
       return bcode;
-    iter++;
-  }
+    }
+
+    if (++iter == m_clients.end())
+      iter = m_clients.begin();
+  } while (iter != start);
+
   return bcode;
 }
 
@@ -76,6 +76,7 @@ namespace EVENTSERVER
     void ProcessEvents();
     void RefreshClients();
 
+    // only the server thread adds or removes clients, other threads need m_critSection to read the map
     std::map<unsigned long, EVENTCLIENT::CEventClient*>  m_clients;
     static CEventServer* m_pInstance;
     SOCKETS::CUDPSocket* m_pSocket;
@@ -86,6 +87,9 @@ namespace EVENTSERVER
     bool             m_bRunning;
     CCriticalSection m_critSection;
     bool             m_bRefreshSettings;
+    unsigned int     m_iLastRefresh;       // time of the last client list refresh
+    unsigned long    m_iLastButtonClient;  // token of the client that sent the last button
+    unsigned long    m_iLastActionClient;  // token of the client that sent the last action
   };
 
 }
@@ -31,8 +31,20 @@
 #include "utils/log.h"
 #include "utils/Variant.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 #include "websocket/WebSocketManager.h"
 
+#include <algorithm>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#define HAS_EPOLL
+#endif
+
 static const char     bt_service_name[] = "XBMC JSON-RPC";
 static const char     bt_service_desc[] = "Interface for XBMC remote control over bluetooth";
 static const char     bt_service_prov[] = "XBMC JSON-RPC Provider";
@@ -55,6 +67,50 @@ using namespace ANNOUNCEMENT;
 //using namespace std; On VS2010, bind conflicts with std::bind
 
 #define RECEIVEBUFFER 1024
+#define MAX_EVENTS 64
+// announcements are dropped while this much is queued up behind the output being written
+#define MAX_OUTPUT_QUEUE (8 * 1024 * 1024)
+// clients that didn't take any of their output for this long (in ms) are dropped
+#define OUTPUT_STALL_TIMEOUT 30000
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static bool WouldBlock()
+{
+#ifdef _WIN32
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+#endif
+}
+
+class CTCPServer::CRequestJob : public CJob
+{
+public:
+  CRequestJob(CTCPServer *host, CTCPClient *client) : m_host(host), m_client(client), m_done(false) {}
+  virtual ~CRequestJob()
+  {
+    // a job cancelled before it ran still has to release the client
+    if (!m_done)
+      m_client->DropRequests();
+  }
+
+  virtual bool DoWork()
+  {
+    m_client->ProcessRequests(m_host);
+    m_done = true;
+    return true;
+  }
+
+  virtual const char *GetType() const { return "jsonrpcrequest"; }
+
+private:
+  CTCPServer *m_host;
+  CTCPClient *m_client;
+  bool m_done;
+};
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -90,6 +146,8 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("CTCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
+  m_wakeup[0] = m_wakeup[1] = -1;
 }
 
 void CTCPServer::Process()
@@ -98,112 +156,286 @@ void CTCPServer::Process()
 
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
+    std::vector<SOCKET> readable, writable;
+    if (!WaitForEvents(readable, writable))
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for socket events failed");
+      Sleep(1000);
+      Initialize();
+      continue;
+    }
 
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+    for (std::vector<SOCKET>::const_iterator it = writable.begin(); it != writable.end(); ++it)
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      int index = FindConnection(*it);
+      if (index >= 0)
+        m_connections[index]->Flush();
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    bool reinitialize = false;
+    for (std::vector<SOCKET>::const_iterator it = readable.begin(); it != readable.end() && !reinitialize; ++it)
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      if (IsServerSocket(*it))
+        reinitialize = !AcceptConnection(*it);
+      else
+      {
+        int index = FindConnection(*it);
+        if (index >= 0)
+          ReadFromConnection(index);
+      }
     }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
-    if (res < 0)
+    if (reinitialize)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
+      continue;
     }
-    else if (res > 0)
+
+    for (int i = m_connections.size() - 1; i >= 0; i--)
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
+      CTCPClient *client = m_connections[i];
+      if (client->HasFailed() || client->Closing())
       {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (response.size() > 0)
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
-
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
+        CloseConnection(i);
+        continue;
       }
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+      // only wait for the socket to become writable while there is something to write
+      bool pending = client->Flush();
+      if (pending != client->m_watchingOutput)
       {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+        client->m_watchingOutput = pending;
+        WatchSocket(client->m_socket, false, pending);
       }
     }
+
+    RemoveClosedConnections(false);
   }
 
   Deinitialize();
 }
 
+bool CTCPServer::WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event events[MAX_EVENTS];
+  int res = epoll_wait(m_epoll, events, MAX_EVENTS, 1000);
+  if (res < 0)
+    return errno == EINTR;
+
+  for (int i = 0; i < res; i++)
+  {
+    SOCKET socket = events[i].data.fd;
+    if (socket == m_wakeup[0])
+    {
+      char buffer[64];
+      while (read(m_wakeup[0], buffer, sizeof(buffer)) > 0);
+      continue;
+    }
+
+    if (events[i].events & (EPOLLIN | EPOLLERR | EPOLLHUP))
+      readable.push_back(socket);
+    if (events[i].events & EPOLLOUT)
+      writable.push_back(socket);
+  }
+  return true;
+#else
+  SOCKET          max_fd = 0;
+  fd_set          rfds, wfds;
+  struct timeval  to     = {1, 0};
+  FD_ZERO(&rfds);
+  FD_ZERO(&wfds);
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    FD_SET(*it, &rfds);
+    if ((intptr_t)*it > (intptr_t)max_fd)
+      max_fd = *it;
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    FD_SET(m_connections[i]->m_socket, &rfds);
+    if (m_connections[i]->m_watchingOutput)
+      FD_SET(m_connections[i]->m_socket, &wfds);
+    if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
+      max_fd = m_connections[i]->m_socket;
+  }
+
+#ifndef _WIN32
+  FD_SET(m_wakeup[0], &rfds);
+  if ((intptr_t)m_wakeup[0] > (intptr_t)max_fd)
+    max_fd = m_wakeup[0];
+#endif
+
+  int res = select((intptr_t)max_fd+1, &rfds, &wfds, NULL, &to);
+  if (res < 0)
+    return false;
+
+#ifndef _WIN32
+  if (FD_ISSET(m_wakeup[0], &rfds))
+  {
+    char buffer[64];
+    while (read(m_wakeup[0], buffer, sizeof(buffer)) > 0);
+  }
+#endif
+
+  for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); it++)
+  {
+    if (FD_ISSET(*it, &rfds))
+      readable.push_back(*it);
+  }
+
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    if (FD_ISSET(m_connections[i]->m_socket, &rfds))
+      readable.push_back(m_connections[i]->m_socket);
+    if (FD_ISSET(m_connections[i]->m_socket, &wfds))
+      writable.push_back(m_connections[i]->m_socket);
+  }
+  return true;
+#endif
+}
+
+void CTCPServer::WatchSocket(SOCKET socket, bool add, bool output)
+{
+#ifdef HAS_EPOLL
+  struct epoll_event event = {};
+  event.events  = EPOLLIN | (output ? EPOLLOUT : 0);
+  event.data.fd = socket;
+  if (epoll_ctl(m_epoll, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, socket, &event) < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch socket %d, errno=%d", (int)socket, errno);
+#endif
+}
+
+void CTCPServer::WakeUp()
+{
+#ifndef _WIN32
+  // on windows the remaining output is picked up when select() times out
+  if (m_wakeup[1] >= 0)
+  {
+    char c = 0;
+    if (write(m_wakeup[1], &c, 1) < 0 && errno != EAGAIN)
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to wake up the server thread, errno=%d", errno);
+  }
+#endif
+}
+
+bool CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    int error = errno;
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", error);
+    delete newconnection;
+    return EBADF != error;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+#ifdef _WIN32
+  unsigned long nonblocking = 1;
+  ioctlsocket(newconnection->m_socket, FIONBIO, &nonblocking);
+#else
+  fcntl(newconnection->m_socket, F_SETFL, fcntl(newconnection->m_socket, F_GETFL) | O_NONBLOCK);
+#endif
+  newconnection->m_host = this;
+
+  CSingleLock lock(m_critSection);
+  m_connections.push_back(newconnection);
+  WatchSocket(newconnection->m_socket, true, false);
+  return true;
+}
+
+void CTCPServer::ReadFromConnection(unsigned int index)
+{
+  int socket = m_connections[index]->m_socket;
+  char buffer[RECEIVEBUFFER] = {};
+  int  nread = 0;
+  nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
+  if (nread < 0 && WouldBlock())
+    return;
+
+  bool close = false;
+  if (nread > 0)
+  {
+    std::string response;
+    if (m_connections[index]->IsNew())
+    {
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
+
+      if (response.size() > 0)
+        m_connections[index]->Send(response.c_str(), response.size());
+
+      if (websocket != NULL)
+      {
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[index]));
+        CSingleLock lock(m_critSection);
+        delete m_connections[index];
+        m_connections[index] = websocketClient;
+      }
+    }
+
+    if (response.size() <= 0)
+      m_connections[index]->PushBuffer(this, buffer, nread);
+
+    close = m_connections[index]->Closing();
+  }
+  else
+    close = true;
+
+  if (close)
+    CloseConnection(index);
+}
+
+void CTCPServer::CloseConnection(unsigned int index)
+{
+  CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+  CTCPClient *client = m_connections[index];
+  client->Disconnect();
+  // a websocket might still wait for its closing handshake, but we're done with it
+  client->CTCPClient::Disconnect();
+
+  CSingleLock lock(m_critSection);
+  m_connections.erase(m_connections.begin() + index);
+  m_closed.push_back(client);
+}
+
+void CTCPServer::RemoveClosedConnections(bool wait)
+{
+  for (int i = m_closed.size() - 1; i >= 0; i--)
+  {
+    while (wait && m_closed[i]->IsBusy())
+      Sleep(10);
+
+    if (!m_closed[i]->IsBusy())
+    {
+      delete m_closed[i];
+      m_closed.erase(m_closed.begin() + i);
+    }
+  }
+}
+
+int CTCPServer::FindConnection(SOCKET socket) const
+{
+  for (unsigned int i = 0; i < m_connections.size(); i++)
+  {
+    if (m_connections[i]->m_socket == socket)
+      return i;
+  }
+  return -1;
+}
+
+bool CTCPServer::IsServerSocket(SOCKET socket) const
+{
+  return std::find(m_servers.begin(), m_servers.end(), socket) != m_servers.end();
+}
+
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
 {
   return false;
@@ -221,8 +453,10 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact);
+  // serialized once and queued for every subscribed client, the actual writing happens in Process()
+  OutputBuffer str(new std::string(IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, g_advancedSettings.m_jsonOutputCompact)));
 
+  CSingleLock lock(m_critSection);
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
     {
@@ -231,7 +465,7 @@ void CTCPServer::Announce(AnnouncementFlag flag, const char *sender, const char
         continue;
     }
 
-    m_connections[i]->Send(str.c_str(), str.size());
+    m_connections[i]->SendAnnouncement(str);
   }
 }
 
@@ -246,6 +480,30 @@ bool CTCPServer::Initialize()
 
   if(started)
   {
+#ifndef _WIN32
+    if (pipe(m_wakeup) == 0)
+    {
+      fcntl(m_wakeup[0], F_SETFL, fcntl(m_wakeup[0], F_GETFL) | O_NONBLOCK);
+      fcntl(m_wakeup[1], F_SETFL, fcntl(m_wakeup[1], F_GETFL) | O_NONBLOCK);
+    }
+    else
+      m_wakeup[0] = m_wakeup[1] = -1;
+#endif
+#ifdef HAS_EPOLL
+    m_epoll = epoll_create(MAX_EVENTS);
+    if (m_epoll < 0)
+    {
+      CLog::Log(LOGERROR, "JSONRPC Server: Failed to create epoll instance, errno=%d", errno);
+      Deinitialize();
+      return false;
+    }
+    for (std::vector<SOCKET>::const_iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+      WatchSocket(*it, true, false);
+    if (m_wakeup[0] >= 0)
+      WatchSocket(m_wakeup[0], true, false);
+#endif
+
+
     CAnnouncementManager::AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -475,19 +733,31 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
-  {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
-  }
+  for (int i = m_connections.size() - 1; i >= 0; i--)
+    CloseConnection(i);
 
-  m_connections.clear();
+  // wait for the jobs still working for any of them
+  RemoveClosedConnections(true);
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
 
   m_servers.clear();
 
+#ifdef HAS_EPOLL
+  if (m_epoll >= 0)
+    close(m_epoll);
+  m_epoll = -1;
+#endif
+#ifndef _WIN32
+  for (int i = 0; i < 2; i++)
+  {
+    if (m_wakeup[i] >= 0)
+      close(m_wakeup[i]);
+    m_wakeup[i] = -1;
+  }
+#endif
+
 #ifdef HAVE_LIBBLUETOOTH
   if(m_sdpd)
     sdp_close( (sdp_session_t*)m_sdpd );
@@ -499,6 +769,13 @@ void CTCPServer::Deinitialize()
 
 CTCPServer::CTCPClient::CTCPClient()
 {
+  m_host = NULL;
+  m_watchingOutput = false;
+  m_processing = false;
+  m_outputSize = 0;
+  m_outputOffset = 0;
+  m_lastOutput = 0;
+  m_failed = false;
   m_new = true;
   m_announcementflags = ANNOUNCE_ALL;
   m_socket = INVALID_SOCKET;
@@ -539,12 +816,127 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  Queue(OutputBuffer(new std::string(data, size)), false);
+}
+
+void CTCPServer::CTCPClient::SendAnnouncement(const OutputBuffer &buffer)
+{
+  Queue(buffer, true);
+}
+
+bool CTCPServer::CTCPClient::IsOutputFull(size_t size)
+{
+  CSingleLock lock (m_critSection);
+  // the buffer being written doesn't count, a large response may take a while
+  size_t queued = m_outputSize;
+  if (!m_output.empty())
+    queued -= m_output.front()->size() - m_outputOffset;
+  return queued + size > MAX_OUTPUT_QUEUE;
+}
+
+void CTCPServer::CTCPClient::Queue(const OutputBuffer &buffer, bool announcement)
+{
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET || m_failed)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (IsOutputFull(buffer->size()))
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data, size - sent, 0);
-  } while (sent < size);
+    if (announcement)
+    {
+      CLog::Log(LOGDEBUG, "JSONRPC Server: Client is behind on its output, dropping an announcement");
+      return;
+    }
+
+    // responses can't be dropped, but a client that doesn't take any of its output isn't going to
+    if (now - m_lastOutput > OUTPUT_STALL_TIMEOUT)
+    {
+      CLog::Log(LOGWARNING, "JSONRPC Server: Client isn't reading its output, disconnecting it");
+      m_failed = true;
+      if (m_host)
+        m_host->WakeUp();
+      return;
+    }
+  }
+
+  bool idle = m_output.empty();
+  if (idle)
+    m_lastOutput = now;
+  m_output.push_back(buffer);
+  m_outputSize += buffer->size();
+
+  // try writing right away, only what the socket doesn't take is left to the server thread
+  if (idle && Flush() && m_host)
+    m_host->WakeUp();
+}
+
+bool CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  while (!m_output.empty() && m_socket != INVALID_SOCKET && !m_failed)
+  {
+    const std::string &buffer = *m_output.front();
+    int sent = send(m_socket, buffer.c_str() + m_outputOffset, buffer.size() - m_outputOffset, MSG_NOSIGNAL);
+    if (sent < 0)
+    {
+      if (!WouldBlock())
+        m_failed = true;
+      break;
+    }
+
+    m_outputOffset += sent;
+    m_outputSize -= sent;
+    if (sent > 0)
+      m_lastOutput = XbmcThreads::SystemClockMillis();
+    if (m_outputOffset >= buffer.size())
+    {
+      m_output.pop_front();
+      m_outputOffset = 0;
+    }
+  }
+  return !m_output.empty() && !m_failed;
+}
+
+bool CTCPServer::CTCPClient::HasFailed()
+{
+  CSingleLock lock (m_critSection);
+  return m_failed;
+}
+
+bool CTCPServer::CTCPClient::IsBusy()
+{
+  CSingleLock lock (m_critSection);
+  return m_processing;
+}
+
+void CTCPServer::CTCPClient::DropRequests()
+{
+  CSingleLock lock (m_critSection);
+  m_requests.clear();
+  m_processing = false;
+}
+
+void CTCPServer::CTCPClient::ProcessRequests(CTCPServer *host)
+{
+  while (true)
+  {
+    std::string request;
+    {
+      CSingleLock lock (m_critSection);
+      if (m_requests.empty() || m_socket == INVALID_SOCKET)
+      {
+        m_requests.clear();
+        m_processing = false;
+        return;
+      }
+      request = m_requests.front();
+      m_requests.pop_front();
+    }
+
+    std::string line = CJSONRPC::MethodCall(request, host, this);
+    Send(line.c_str(), line.size());
+  }
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -575,8 +967,18 @@ void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, in
         m_endBrackets++;
       if (m_beginBrackets > 0 && m_endBrackets > 0 && m_beginBrackets == m_endBrackets)
       {
-        std::string line = CJSONRPC::MethodCall(m_buffer, host, this);
-        Send(line.c_str(), line.size());
+        // requests are handled on the job manager, one at a time to keep the responses in order
+        {
+          CSingleLock lock (m_critSection);
+          m_requests.push_back(m_buffer);
+          if (!m_processing)
+          {
+            m_processing = true;
+            CRequestJob *job = new CRequestJob(host, this);
+            if (CJobManager::GetInstance().AddJob(job, NULL, CJob::PRIORITY_HIGH) == 0)
+              delete job; // the job manager is shutting down
+          }
+        }
         m_beginChar = m_beginBrackets = m_endBrackets = 0;
         m_buffer.clear();
       }
@@ -592,6 +994,9 @@ void CTCPServer::CTCPClient::Disconnect()
     shutdown(m_socket, SHUT_RDWR);
     closesocket(m_socket);
     m_socket = INVALID_SOCKET;
+    m_output.clear();
+    m_outputSize = 0;
+    m_outputOffset = 0;
   }
 }
 
@@ -607,6 +1012,15 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_host              = client.m_host;
+  m_watchingOutput    = client.m_watchingOutput;
+  m_requests          = client.m_requests;
+  m_processing        = client.m_processing;
+  m_output            = client.m_output;
+  m_outputSize        = client.m_outputSize;
+  m_outputOffset      = client.m_outputOffset;
+  m_lastOutput        = client.m_lastOutput;
+  m_failed            = client.m_failed;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -651,6 +1065,18 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
     CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
 }
 
+void CTCPServer::CWebSocketClient::SendAnnouncement(const OutputBuffer &buffer)
+{
+  if (IsOutputFull(buffer->size()))
+  {
+    CLog::Log(LOGDEBUG, "JSONRPC Server: Client is behind on its output, dropping an announcement");
+    return;
+  }
+
+  // every websocket frames the message by itself
+  Send(buffer->c_str(), buffer->size());
+}
+
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
 {
   bool send;
@@ -19,8 +19,11 @@
  *
  */
 
+#include <deque>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
+#include <boost/shared_ptr.hpp>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/IJSONRPCAnnouncer.h"
@@ -51,6 +54,22 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    bool WaitForEvents(std::vector<SOCKET> &readable, std::vector<SOCKET> &writable);
+    void WatchSocket(SOCKET socket, bool add, bool output);
+    void WakeUp();
+    bool AcceptConnection(SOCKET server);
+    void ReadFromConnection(unsigned int index);
+    void CloseConnection(unsigned int index);
+    void RemoveClosedConnections(bool wait);
+    int  FindConnection(SOCKET socket) const;
+    bool IsServerSocket(SOCKET socket) const;
+
+    typedef boost::shared_ptr<const std::string> OutputBuffer;
+
+    /*! \brief Works off the requests of a single client on the job manager, one after the other
+     */
+    class CRequestJob;
+
     class CTCPClient : public IClient
     {
     public:
@@ -66,25 +85,49 @@ namespace JSONRPC
       virtual bool SetAnnouncementFlags(int flags);
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendAnnouncement(const OutputBuffer &buffer);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
       virtual bool IsNew() const { return m_new; }
       virtual bool Closing() const { return false; }
 
+      /*! \brief Write as much of the queued output as the socket takes without blocking
+       \return true if output is left for when the socket becomes writable again
+       */
+      bool Flush();
+      bool HasFailed();
+      bool IsBusy();
+      void ProcessRequests(CTCPServer *host);
+      void DropRequests();
+
       SOCKET           m_socket;
       sockaddr_storage m_cliaddr;
       socklen_t        m_addrlen;
       CCriticalSection m_critSection;
+      CTCPServer      *m_host;
+      bool             m_watchingOutput;
 
     protected:
       void Copy(const CTCPClient& client);
+      /*! \brief Queue output, announcements are dropped while the client is behind on its output
+       */
+      void Queue(const OutputBuffer &buffer, bool announcement);
+      bool IsOutputFull(size_t size);
     private:
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+
+      std::deque<std::string> m_requests;   // complete requests waiting to be processed
+      bool m_processing;                    // a job is working off m_requests
+      std::deque<OutputBuffer> m_output;    // responses and announcements not yet written
+      size_t m_outputSize;
+      size_t m_outputOffset;                // bytes of m_output.front() already written
+      unsigned int m_lastOutput;            // when the client last took some of its output
+      bool m_failed;                        // the socket failed or the client stopped reading its output
     };
 
     class CWebSocketClient : public CTCPClient
@@ -97,6 +140,7 @@ namespace JSONRPC
       ~CWebSocketClient();
 
       virtual void Send(const char *data, unsigned int size);
+      virtual void SendAnnouncement(const OutputBuffer &buffer);
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -108,7 +152,11 @@ namespace JSONRPC
     };
 
     std::vector<CTCPClient*> m_connections;
+    std::vector<CTCPClient*> m_closed;  // disconnected, but a job may still be using them
     std::vector<SOCKET> m_servers;
+    CCriticalSection m_critSection;     // guards changes to m_connections against Announce()
+    int m_epoll;                        // epoll instance, where available
+    int m_wakeup[2];                    // pipe interrupting the wait for socket events
     int m_port;
     bool m_nonlocal;
     void* m_sdpd;
@@ -25,15 +25,32 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "utils/Base64.h"
+#include "utils/StringUtils.h"
 #include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "filesystem/SpecialProtocol.h"
 #include "XBDateTime.h"
 #include "URL.h"
 
+#include <algorithm>
+#ifdef HAS_WEB_SERVER_SENDFILE
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #ifdef _WIN32
 #pragma comment(lib, "libmicrohttpd.dll.lib")
 #endif
 
 #define MAX_POST_BUFFER_SIZE 2048
+// files not served with sendfile() are read and sent in blocks of this size
+#define FILE_DOWNLOAD_BLOCK_SIZE (64 * 1024)
+#define WEB_SERVER_THREAD_POOL_SIZE 8
+
+// libmicrohttpd < 0.4.6 doesn't name the size of a stream of unknown length
+#ifndef MHD_SIZE_UNKNOWN
+#define MHD_SIZE_UNKNOWN -1
+#endif
 
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
@@ -43,11 +60,14 @@ using namespace std;
 using namespace JSONRPC;
 
 vector<IHTTPRequestHandler *> CWebServer::m_requestHandlers;
+CWebServer::Statistics CWebServer::m_statistics;
+CCriticalSection CWebServer::m_statisticsSection;
 
 CWebServer::CWebServer()
 {
   m_running = false;
   m_daemon = NULL;
+  m_startTime = 0;
   m_needcredentials = true;
   m_Credentials64Encoded = "eGJtYzp4Ym1j"; // xbmc:xbmc
 }
@@ -360,29 +380,62 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
 
   if (file->Open(strURL, READ_NO_CACHE))
   {
+    int64_t fileLength = file->GetLength();
+
+    // the last modification time and the entity tag derived from it and the size
+    bool hasLastModified = false;
+    CDateTime lastModified;
+    CStdString etag;
+    struct __stat64 statBuffer;
+    if (file->Stat(&statBuffer) == 0)
+    {
+      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
+      if (time != NULL)
+      {
+        lastModified = *time;
+        hasLastModified = true;
+      }
+      // without a known size the entity tag couldn't tell versions of the same age apart
+      if (fileLength >= 0)
+        etag.Format("\"%"PRIx64"-%"PRIx64"\"", (uint64_t)statBuffer.st_mtime, (uint64_t)fileLength);
+    }
+
     bool getData = true;
+    bool ranged = false;
+    int64_t rangeStart = 0, rangeEnd = fileLength - 1;
     if (methodType != HEAD)
     {
       if (methodType == GET)
       {
-        string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
-        if (!ifModifiedSince.empty())
+        if (IsNotModified(connection, etag, hasLastModified ? &lastModified : NULL))
         {
-          CDateTime ifModifiedSinceDate;
-          ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
-
-          struct __stat64 statBuffer;
-          if (file->Stat(&statBuffer) == 0)
+          getData = false;
+          response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+          responseCode = MHD_HTTP_NOT_MODIFIED;
+        }
+        else if (fileLength > 0)
+        {
+          string range = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "Range");
+          string ifRange = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Range");
+          // If-Range asks for the whole file unless it still is the version the client has part of
+          if (!range.empty() && (ifRange.empty() || ifRange == etag ||
+                                 (hasLastModified && ifRange == lastModified.GetAsRFC1123DateTime())))
           {
-            struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-            if (time != NULL)
+            if (ParseRangeHeader(range, fileLength, rangeStart, rangeEnd))
+            {
+              ranged = true;
+              responseCode = MHD_HTTP_PARTIAL_CONTENT;
+            }
+            else
             {
-              CDateTime lastModified = *time;
-              if (lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
+              getData = false;
+              response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
+              responseCode = MHD_HTTP_REQUESTED_RANGE_NOT_SATISFIABLE;
+              if (response)
               {
-                getData = false;
-                response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
-                responseCode = MHD_HTTP_NOT_MODIFIED;
+                CStdString contentRange;
+                contentRange.Format("bytes */%"PRId64, fileLength);
+                MHD_add_response_header(response, "Content-Range", contentRange);
               }
             }
           }
@@ -390,14 +443,51 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       }
 
       if (getData)
-        response = MHD_create_response_from_callback(file->GetLength(),
-                                                     2048,
-                                                     &CWebServer::ContentReaderCallback, file,
-                                                     &CWebServer::ContentReaderFreeCallback);
+      {
+        // streams of unknown length (e.g. some network files) are read until they end
+        uint64_t length = fileLength > 0 ? rangeEnd - rangeStart + 1 : 0;
+        if (fileLength < 0)
+          length = MHD_SIZE_UNKNOWN;
+#ifdef HAS_WEB_SERVER_SENDFILE
+        int fd = fileLength >= 0 ? OpenLocalFile(strURL) : -1;
+        if (fd >= 0)
+        {
+          // local files are sent by the kernel straight from the page cache
+          file->Close();
+          delete file;
+          file = NULL;
+          getData = false;
+          response = MHD_create_response_from_fd_at_offset(length, fd, rangeStart);
+          if (response == NULL)
+          {
+            close(fd);
+            return MHD_NO;
+          }
+          UpdateStatistics(true, length);
+        }
+        else
+#endif
+        {
+          FileDownload *download = new FileDownload;
+          download->file   = file;
+          download->offset = rangeStart;
+          response = MHD_create_response_from_callback(length,
+                                                       FILE_DOWNLOAD_BLOCK_SIZE,
+                                                       &CWebServer::ContentReaderCallback, download,
+                                                       &CWebServer::ContentReaderFreeCallback);
+          if (response == NULL)
+            delete download;
+          else
+            UpdateStatistics(false, 0);
+        }
+      }
       if (response == NULL)
       {
-        file->Close();
-        delete file;
+        if (file)
+        {
+          file->Close();
+          delete file;
+        }
         return MHD_NO;
       }
     }
@@ -406,7 +496,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       getData = false;
 
       CStdString contentLength;
-      contentLength.Format("%I64d", file->GetLength());
+      contentLength.Format("%I64d", fileLength);
 
       response = MHD_create_response_from_data (0, NULL, MHD_NO, MHD_NO);
       if (response == NULL)
@@ -415,9 +505,20 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
         delete file;
         return MHD_NO;
       }
-      MHD_add_response_header(response, "Content-Length", contentLength);
+      if (fileLength >= 0)
+        MHD_add_response_header(response, "Content-Length", contentLength);
     }
 
+    MHD_add_response_header(response, "Accept-Ranges", fileLength >= 0 ? "bytes" : "none");
+    if (ranged)
+    {
+      CStdString contentRange;
+      contentRange.Format("bytes %"PRId64"-%"PRId64"/%"PRId64, rangeStart, rangeEnd, fileLength);
+      MHD_add_response_header(response, "Content-Range", contentRange);
+    }
+    if (!etag.empty())
+      MHD_add_response_header(response, "ETag", etag);
+
     // set the Content-Type header
     CStdString ext = URIUtils::GetExtension(strURL);
     ext = ext.ToLower();
@@ -426,16 +527,8 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
       MHD_add_response_header(response, "Content-Type", mime);
 
     // set the Last-Modified header
-    struct __stat64 statBuffer;
-    if (file->Stat(&statBuffer) == 0)
-    {
-      struct tm *time = localtime((time_t *)&statBuffer.st_mtime);
-      if (time != NULL)
-      {
-        CDateTime lastModified = *time;
-        MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
-      }
-    }
+    if (hasLastModified)
+      MHD_add_response_header(response, "Last-Modified", lastModified.GetAsRFC1123DateTime());
 
     // set the Expires header
     CDateTime expiryTime = CDateTime::GetCurrentDateTime();
@@ -446,7 +539,7 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
     MHD_add_response_header(response, "Expires", expiryTime.GetAsRFC1123DateTime());
 
     // only close the CFile instance if libmicrohttpd doesn't have to grab the data of the file
-    if (!getData)
+    if (!getData && file)
     {
       file->Close();
       delete file;
@@ -461,6 +554,91 @@ int CWebServer::CreateFileDownloadResponse(struct MHD_Connection *connection, co
   return MHD_YES;
 }
 
+bool CWebServer::IsNotModified(struct MHD_Connection *connection, const std::string &etag, const CDateTime *lastModified)
+{
+  // If-None-Match takes precedence over If-Modified-Since
+  string ifNoneMatch = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-None-Match");
+  if (!ifNoneMatch.empty())
+    return ifNoneMatch == "*" || (!etag.empty() && ifNoneMatch.find(etag) != string::npos);
+
+  string ifModifiedSince = GetRequestHeaderValue(connection, MHD_HEADER_KIND, "If-Modified-Since");
+  if (ifModifiedSince.empty() || lastModified == NULL)
+    return false;
+
+  CDateTime ifModifiedSinceDate;
+  ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince);
+  return lastModified->GetAsUTCDateTime() <= ifModifiedSinceDate;
+}
+
+bool CWebServer::ParseRangeHeader(const std::string &range, int64_t length, int64_t &start, int64_t &end)
+{
+  start = 0;
+  end = length - 1;
+
+  // only a single range is supported, multipart/byteranges responses are not
+  if (range.compare(0, 6, "bytes=") != 0 || range.find(',') != string::npos)
+    return false;
+
+  string spec = range.substr(6);
+  size_t dash = spec.find('-');
+  if (dash == string::npos)
+    return false;
+
+  string first = spec.substr(0, dash);
+  string last = spec.substr(dash + 1);
+  StringUtils::Trim(first);
+  StringUtils::Trim(last);
+  if (first.empty())
+  {
+    // a suffix range, i.e. the last n bytes
+    int64_t suffix = strtoll(last.c_str(), NULL, 10);
+    if (last.empty() || suffix <= 0)
+      return false;
+    start = suffix < length ? length - suffix : 0;
+    return true;
+  }
+
+  start = strtoll(first.c_str(), NULL, 10);
+  if (start < 0 || start >= length)
+    return false;
+  if (!last.empty())
+  {
+    end = strtoll(last.c_str(), NULL, 10);
+    if (end < start)
+      return false;
+    if (end >= length)
+      end = length - 1;
+  }
+  return true;
+}
+
+#ifdef HAS_WEB_SERVER_SENDFILE
+int CWebServer::OpenLocalFile(const std::string &strURL)
+{
+  CStdString path = CSpecialProtocol::TranslatePath(strURL);
+  if (path.empty() || path[0] != '/')
+    return -1;
+
+  return open(path.c_str(), O_RDONLY);
+}
+#endif
+
+void CWebServer::UpdateStatistics(bool zeroCopy, uint64_t bytes)
+{
+  CSingleLock lock(m_statisticsSection);
+  m_statistics.fileRequests++;
+  if (zeroCopy)
+    m_statistics.zeroCopyRequests++;
+  m_statistics.bytesSent += bytes;
+}
+
+void CWebServer::GetStatistics(Statistics &statistics)
+{
+  CSingleLock lock(m_statisticsSection);
+  statistics = m_statistics;
+  statistics.uptime = m_running ? XbmcThreads::SystemClockMillis() - m_startTime : 0;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response)
 {
   size_t payloadSize = 0;
@@ -522,21 +700,26 @@ int CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, int ma
 int CWebServer::ContentReaderCallback(void *cls, size_t pos, char *buf, int max)
 #endif
 {
-  CFile *file = (CFile *)cls;
-  if((unsigned int)pos != file->GetPosition())
-    file->Seek(pos);
-  unsigned res = file->Read(buf, max);
+  FileDownload *download = (FileDownload *)cls;
+  int64_t position = download->offset + pos;
+  if (position != download->file->GetPosition())
+    download->file->Seek(position);
+  unsigned res = download->file->Read(buf, max);
   if(res == 0)
     return -1;
+
+  CSingleLock lock(m_statisticsSection);
+  m_statistics.bytesSent += res;
   return res;
 }
 
 void CWebServer::ContentReaderFreeCallback(void *cls)
 {
-  CFile *file = (CFile *)cls;
-  file->Close();
+  FileDownload *download = (FileDownload *)cls;
+  download->file->Close();
 
-  delete file;
+  delete download->file;
+  delete download;
 }
 
 struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
@@ -544,7 +727,10 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
   unsigned int timeout = 60 * 60 * 24;
 
   return MHD_start_daemon(flags |
-#if (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
+#ifdef HAS_WEB_SERVER_EPOLL
+                          // a fixed pool of threads, each serving its connections from an epoll loop
+                          MHD_USE_SELECT_INTERNALLY | MHD_USE_EPOLL_LINUX_ONLY
+#elif (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
                           // use main thread for each connection, can only handle one request at a
                           // time [unless you set the thread pool size]
                           MHD_USE_SELECT_INTERNALLY
@@ -561,7 +747,9 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 
-#if (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
+#ifdef HAS_WEB_SERVER_EPOLL
+                          MHD_OPTION_THREAD_POOL_SIZE, WEB_SERVER_THREAD_POOL_SIZE,
+#elif (MHD_VERSION >= 0x00040002) && (MHD_VERSION < 0x00090B01)
                           MHD_OPTION_THREAD_POOL_SIZE, 4,
 #endif
                           MHD_OPTION_CONNECTION_LIMIT, 512,
@@ -579,7 +767,12 @@ bool CWebServer::Start(int port, const string &username, const string &password)
 
     m_running = m_daemon != NULL;
     if (m_running)
+    {
+      CSingleLock lock(m_statisticsSection);
+      m_statistics = Statistics();
+      m_startTime = XbmcThreads::SystemClockMillis();
       CLog::Log(LOGNOTICE, "WebServer: Started the webserver");
+    }
     else
       CLog::Log(LOGERROR, "WebServer: Failed to start the webserver");
   }
@@ -591,6 +784,13 @@ bool CWebServer::Stop()
   if (m_running)
   {
     MHD_stop_daemon(m_daemon);
+
+    Statistics statistics;
+    GetStatistics(statistics);
+    unsigned int seconds = std::max(statistics.uptime / 1000, 1u);
+    CLog::Log(LOGNOTICE, "WebServer: Served %u files (%u zero-copy), %"PRIu64" bytes in %us (%"PRIu64" bytes/s)",
+              statistics.fileRequests, statistics.zeroCopyRequests, statistics.bytesSent, seconds, statistics.bytesSent / seconds);
+
     m_running = false;
     CLog::Log(LOGNOTICE, "WebServer: Stopped the webserver");
   } else 
@@ -33,6 +33,19 @@
 #include "threads/CriticalSection.h"
 #include "httprequesthandler/IHTTPRequestHandler.h"
 
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00091400)
+#define HAS_WEB_SERVER_SENDFILE
+#endif
+#if defined(TARGET_LINUX) && (MHD_VERSION >= 0x00093300)
+#define HAS_WEB_SERVER_EPOLL
+#endif
+
+class CDateTime;
+namespace XFILE
+{
+  class CFile;
+}
+
 class CWebServer : public JSONRPC::ITransportLayer
 {
 public:
@@ -51,6 +64,16 @@ public:
   static void RegisterRequestHandler(IHTTPRequestHandler *handler);
   static void UnregisterRequestHandler(IHTTPRequestHandler *handler);
 
+  struct Statistics
+  {
+    Statistics() : fileRequests(0), zeroCopyRequests(0), bytesSent(0), uptime(0) {}
+    unsigned int fileRequests;      //!< file downloads served
+    unsigned int zeroCopyRequests;  //!< file downloads handed to sendfile()
+    uint64_t     bytesSent;         //!< bytes of file downloads sent
+    unsigned int uptime;            //!< milliseconds since the server was started
+  };
+  void GetStatistics(Statistics &statistics);
+
   static std::string GetRequestHeaderValue(struct MHD_Connection *connection, enum MHD_ValueKind kind, const std::string &key);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::map<std::string, std::string> &headerValues);
   static int GetRequestHeaderValues(struct MHD_Connection *connection, enum MHD_ValueKind kind, std::multimap<std::string, std::string> &headerValues);
@@ -92,6 +115,12 @@ private:
   static void ContentReaderFreeCallback (void *cls);
   static int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response);
   static int CreateFileDownloadResponse(struct MHD_Connection *connection, const std::string &strURL, HTTPMethod methodType, struct MHD_Response *&response, int &responseCode);
+  static bool IsNotModified(struct MHD_Connection *connection, const std::string &etag, const CDateTime *lastModified);
+  static bool ParseRangeHeader(const std::string &range, int64_t length, int64_t &start, int64_t &end);
+#ifdef HAS_WEB_SERVER_SENDFILE
+  static int OpenLocalFile(const std::string &strURL);
+#endif
+  static void UpdateStatistics(bool zeroCopy, uint64_t bytes);
   static int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response);
   static int CreateMemoryDownloadResponse(struct MHD_Connection *connection, void *data, size_t size, bool free, bool copy, struct MHD_Response *&response);
 
@@ -108,6 +137,15 @@ private:
   std::string m_Credentials64Encoded;
   CCriticalSection m_critSection;
   static std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  unsigned int m_startTime;
+  static Statistics m_statistics;
+  static CCriticalSection m_statisticsSection;
+
+  typedef struct FileDownload
+  {
+    XFILE::CFile *file;
+    int64_t offset;   //!< position in the file the response starts at
+  } FileDownload;
 
   typedef struct ConnectionHandler
   {
@@ -18,6 +18,7 @@
 #include "utils/md5.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
+#include "utils/SortUtils.h"
 #include "music/MusicDatabase.h"
 #include "video/VideoDatabase.h"
 
@@ -30,6 +31,9 @@ namespace UPNP
 
 NPT_UInt32 CUPnPServer::m_MaxReturnedItems = 0;
 
+// upper bound on the number of serialized objects kept around
+#define UPNP_MAX_CACHED_DIDL 20000
+
 const char* audio_containers[] = { "musicdb://1/", "musicdb://2/", "musicdb://3/",
                                    "musicdb://4/", "musicdb://6/", "musicdb://9/",
                                    "musicdb://10/" };
@@ -43,6 +47,7 @@ const char* video_containers[] = { "videodb://1/2/", "videodb://2/2/", "videodb:
 CUPnPServer::CUPnPServer(const char* friendly_name, const char* uuid /*= NULL*/, int port /*= 0*/) :
     PLT_MediaConnect(friendly_name, false, uuid, port),
     PLT_FileMediaConnectDelegate("/", "/"),
+    m_DidlGeneration(0),
     m_scanning(g_application.IsMusicScanning() || g_application.IsVideoScanning())
 {
 }
@@ -376,6 +381,12 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
     if (strcmp(sender, "xbmc"))
         return;
 
+    // any library change may alter the metadata of objects we already serialized
+    if ((flag == AudioLibrary || flag == VideoLibrary) &&
+        (!strcmp(message, "OnUpdate") || !strcmp(message, "OnRemove") ||
+         !strcmp(message, "OnScanFinished") || !strcmp(message, "OnCleanFinished")))
+        FlushDidlCache();
+
     if (strcmp(message, "OnUpdate") && strcmp(message, "OnRemove")
         && strcmp(message, "OnScanStarted") && strcmp(message, "OnScanFinished"))
         return;
@@ -582,6 +593,7 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
     if (!load) {
         // cache anything that takes more than a second to retrieve
         unsigned int time = XbmcThreads::SystemClockMillis();
+        bool paged = false;
 
         if (parent_id.StartsWith("virtualpath://upnproot")) {
             CFileItemPtr item;
@@ -599,12 +611,15 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
             items.Add(item);
 
             items.Sort(SORT_METHOD_LABEL, SortOrderAscending);
+        } else if (GetLibraryPage(parent_id, items, starting_index, requested_count)) {
+            // only the requested page was retrieved, nothing worth caching
+            paged = true;
         } else {
             CDirectory::GetDirectory((const char*)parent_id, items);
             DefaultSortItems(items);
         }
 
-        if (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 )) {
+        if (!paged && (items.CacheToDiscAlways() || (items.CacheToDiscIfSlow() && (XbmcThreads::SystemClockMillis() - time) > 1000 ))) {
             NPT_AutoLock lock(m_CacheMutex);
             items.Save();
         }
@@ -666,25 +681,48 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
         }
     }
 
+    // listings paged in the library only hold the items from starting_index on
+    NPT_UInt32 offset = (NPT_UInt32)items.GetProperty("upnp:offset").asInteger();
+
     // won't return more than UPNP_MAX_RETURNED_ITEMS items at a time to keep things smooth
     // 0 requested means as many as possible
     NPT_UInt32 max_count  = (requested_count == 0)?m_MaxReturnedItems:min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
-    NPT_UInt32 stop_index = min((unsigned long)(starting_index + max_count), (unsigned long)items.Size()); // don't return more than we can
+    NPT_UInt32 stop_index = min((unsigned long)(starting_index + max_count), (unsigned long)(offset + items.Size())); // don't return more than we can
 
     NPT_Cardinal count = 0;
-    NPT_Cardinal total = items.Size();
+    NPT_Cardinal total = max((int64_t)(offset + items.Size()), items.GetProperty("total").asInteger());
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
-    for (unsigned long i=starting_index; i<stop_index; ++i) {
-        object = Build(items[i], true, context, thumb_loader, parent_id);
-        if (object.IsNull()) {
-            // don't tell the client this item ever existed
-            --total;
-            continue;
-        }
 
+    // objects serialize the same for a given filter, interface and kind of client
+    // (its quirks and the device type mime types are picked for), so reuse what
+    // earlier requests built unless the library changed meanwhile
+    unsigned int generation;
+    { NPT_AutoLock lock(m_DidlMutex);
+      generation = m_DidlGeneration;
+    }
+    std::string key_suffix = StringUtils::Format("\n%s\n%s\n%s:%d\n%d\n%d",
+                                                 parent_id ? parent_id : "",
+                                                 filter ? filter : "",
+                                                 (const char*)context.GetLocalAddress().GetIpAddress().ToString(),
+                                                 (int)context.GetLocalAddress().GetPort(),
+                                                 (int)GetClientQuirks(&context),
+                                                 (int)PLT_HttpHelper::GetDeviceSignature(context.GetRequest()));
+
+    for (unsigned long i=starting_index; i<stop_index; ++i) {
         NPT_String tmp;
-        NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+        std::string key = items[i - offset]->GetPath() + key_suffix;
+        if (!GetCachedDidl(key, tmp)) {
+            object = Build(items[i - offset], true, context, thumb_loader, parent_id);
+            if (object.IsNull()) {
+                // don't tell the client this item ever existed
+                --total;
+                continue;
+            }
+
+            NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+            CacheDidl(key, tmp, generation);
+        }
 
         // Neptunes string growing is dead slow for small additions
         if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
@@ -707,6 +745,50 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     return NPT_SUCCESS;
 }
 
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetCachedDidl
++---------------------------------------------------------------------*/
+bool
+CUPnPServer::GetCachedDidl(const std::string& key, NPT_String& didl)
+{
+    NPT_AutoLock lock(m_DidlMutex);
+    std::map<std::string, std::string>::const_iterator it = m_DidlCache.find(key);
+    if (it == m_DidlCache.end())
+        return false;
+
+    didl = it->second.c_str();
+    return true;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::CacheDidl
++---------------------------------------------------------------------*/
+void
+CUPnPServer::CacheDidl(const std::string& key, const NPT_String& didl, unsigned int generation)
+{
+    NPT_AutoLock lock(m_DidlMutex);
+
+    // built from data that may have changed since
+    if (generation != m_DidlGeneration)
+        return;
+
+    if (m_DidlCache.size() >= UPNP_MAX_CACHED_DIDL)
+        m_DidlCache.clear();
+
+    m_DidlCache[key] = (const char*)didl;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::FlushDidlCache
++---------------------------------------------------------------------*/
+void
+CUPnPServer::FlushDidlCache()
+{
+    NPT_AutoLock lock(m_DidlMutex);
+    m_DidlCache.clear();
+    ++m_DidlGeneration;
+}
+
 /*----------------------------------------------------------------------
 |   FindSubCriteria
 +---------------------------------------------------------------------*/
@@ -1040,5 +1122,72 @@ CUPnPServer::DefaultSortItems(CFileItemList& items)
   }
 }
 
+bool
+CUPnPServer::GetLibraryPage(const char* path, CFileItemList& items, NPT_UInt32 starting_index, NPT_UInt32 requested_count)
+{
+  CStdString strPath = path;
+  bool music = URIUtils::IsMusicDb(strPath);
+  if (!music && !URIUtils::IsVideoDb(strPath))
+    return false;
+
+  // only flat listings that can grow large are worth paging in the database
+  int type = music ? (int)CMusicDatabaseDirectory::GetDirectoryType(strPath)
+                   : (int)CVideoDatabaseDirectory::GetDirectoryType(strPath);
+  if (music && type != MUSICDATABASEDIRECTORY::NODE_TYPE_SONG &&
+               type != MUSICDATABASEDIRECTORY::NODE_TYPE_ALBUM)
+    return false;
+  if (!music && type != VIDEODATABASEDIRECTORY::NODE_TYPE_TITLE_MOVIES &&
+                type != VIDEODATABASEDIRECTORY::NODE_TYPE_TITLE_TVSHOWS)
+    return false;
+
+  // sort the same way a full listing of the node would be sorted
+  SortDescription sorting;
+  CGUIViewState* viewState = CGUIViewState::GetViewState(music ? -1 : WINDOW_VIDEO_NAV, items);
+  if (viewState)
+  {
+    sorting = SortUtils::TranslateOldSortMethod(viewState->GetSortMethod());
+    sorting.sortOrder = viewState->GetSortOrder();
+    delete viewState;
+  }
+
+  NPT_UInt32 count = (requested_count == 0) ? m_MaxReturnedItems : min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
+  sorting.limitStart = starting_index;
+  sorting.limitEnd = starting_index + count;
+
+  bool success;
+  if (music)
+  {
+    CMusicDatabase db;
+    if (!db.Open())
+      return false;
+    if (type == MUSICDATABASEDIRECTORY::NODE_TYPE_SONG)
+      success = db.GetSongsByWhere(strPath, CDatabase::Filter(), items, sorting);
+    else
+      success = db.GetAlbumsByWhere(strPath, CDatabase::Filter(), items, sorting);
+  }
+  else
+  {
+    CVideoDatabase db;
+    if (!db.Open())
+      return false;
+    if (type == VIDEODATABASEDIRECTORY::NODE_TYPE_TITLE_MOVIES)
+      success = db.GetMoviesByWhere(strPath, CDatabase::Filter(), items, sorting);
+    else
+      success = db.GetTvShowsByWhere(strPath, CDatabase::Filter(), items, sorting);
+  }
+
+  if (!success)
+  {
+    items.Clear();
+    items.ClearProperties();
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "UPnP: Retrieved %d items starting @ %d out of %d from the library for '%s'",
+            items.Size(), starting_index, (int)items.GetProperty("total").asInteger(), path);
+  items.SetProperty("upnp:offset", (int)starting_index);
+  return true;
+}
+
 } /* namespace UPNP */
 
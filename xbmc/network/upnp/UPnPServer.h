@@ -113,6 +113,7 @@ private:
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
     static void DefaultSortItems(CFileItemList& items);
+    static bool GetLibraryPage(const char* path, CFileItemList& items, NPT_UInt32 starting_index, NPT_UInt32 requested_count);
     static NPT_String GetParentFolder(NPT_String file_path) {
         int index = file_path.ReverseFind("\\");
         if (index == -1) return "";
@@ -125,6 +126,16 @@ private:
     NPT_Mutex                       m_FileMutex;
     NPT_Map<NPT_String, NPT_String> m_FileMap;
 
+    /*! \brief serialized DIDL-Lite fragments of already built objects, keyed by
+     object, parent, filter and interface; flushed whenever the library changes */
+    bool GetCachedDidl(const std::string& key, NPT_String& didl);
+    void CacheDidl(const std::string& key, const NPT_String& didl, unsigned int generation);
+    void FlushDidlCache();
+
+    NPT_Mutex                          m_DidlMutex;
+    std::map<std::string, std::string> m_DidlCache;
+    unsigned int                       m_DidlGeneration;
+
     std::map<std::string, std::pair<bool, unsigned long> > m_UpdateIDs;
     bool m_scanning;
 public:
@@ -210,6 +210,11 @@ void CGUIWindowPictures::UpdateButtons()
   }
 }
 
+void CGUIWindowPictures::OnSelectionChanged(const CFileItemPtr &item)
+{
+  m_thumbLoader.PrioritizeItem(item);
+}
+
 void CGUIWindowPictures::OnPrepareFileItems(CFileItemList& items)
 {
   for (int i=0;i<items.Size();++i )
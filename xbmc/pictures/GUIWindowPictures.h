@@ -41,6 +41,7 @@ protected:
   virtual bool OnClick(int iItem);
   virtual void UpdateButtons();
   virtual void OnPrepareFileItems(CFileItemList& items);
+  virtual void OnSelectionChanged(const CFileItemPtr &item);
   virtual bool Update(const CStdString &strDirectory, bool updateFilterPath = true);
   virtual void GetContextButtons(int itemNumber, CContextButtons &buttons);
   virtual bool OnContextButton(int itemNumber, CONTEXT_BUTTON button);
@@ -35,6 +35,8 @@
 #include "pvr/recordings/PVRRecordings.h"
 #include "pvr/timers/PVRTimers.h"
 #include "cores/IPlayer.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
 
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
@@ -45,6 +47,105 @@ using namespace ADDON;
 using namespace PVR;
 using namespace EPG;
 
+/* calls that take longer than this are logged as slow, and the caller logs while it's still waiting for them */
+#define PVR_CLIENT_CALL_SLOW_TIME 10000
+
+namespace PVR
+{
+  static const char *CallToString(PVR_CLIENT_CALL call)
+  {
+    switch (call)
+    {
+    case PVR_CLIENT_CALL_GET_CHANNELS:
+      return "GetChannels";
+    case PVR_CLIENT_CALL_GET_TIMERS:
+      return "GetTimers";
+    case PVR_CLIENT_CALL_GET_RECORDINGS:
+      return "GetRecordings";
+    default:
+      return "unknown";
+    }
+  }
+
+  /*!
+   * @brief Run a single call on one client.
+   */
+  class CPVRClientCallJob : public CJob
+  {
+  public:
+    CPVRClientCallJob(PVR_CLIENT client, PVR_CLIENT_CALL call, void *data) :
+      m_client(client),
+      m_call(call),
+      m_data(data),
+      m_error(PVR_ERROR_UNKNOWN),
+      m_iDuration(0) {}
+    virtual ~CPVRClientCallJob() {}
+    virtual const char *GetType() const { return "pvr-client-call"; }
+
+    virtual bool DoWork(void)
+    {
+      unsigned int iStart = XbmcThreads::SystemClockMillis();
+      switch (m_call)
+      {
+      case PVR_CLIENT_CALL_GET_CHANNELS:
+        {
+          CPVRChannelGroupInternal *group = (CPVRChannelGroupInternal *) m_data;
+          m_error = m_client->GetChannels(*group, group->IsRadio());
+        }
+        break;
+      case PVR_CLIENT_CALL_GET_TIMERS:
+        m_error = m_client->GetTimers((CPVRTimers *) m_data);
+        break;
+      case PVR_CLIENT_CALL_GET_RECORDINGS:
+        m_error = m_client->GetRecordings((CPVRRecordings *) m_data);
+        break;
+      }
+      m_iDuration = XbmcThreads::SystemClockMillis() - iStart;
+      return m_error == PVR_ERROR_NO_ERROR;
+    }
+
+    PVR_CLIENT      m_client;
+    PVR_CLIENT_CALL m_call;
+    void *          m_data;
+    PVR_ERROR       m_error;
+    unsigned int    m_iDuration;
+  };
+
+  /*!
+   * @brief Collect the results of the jobs of a CPVRClients::CallConnectedClients() call.
+   */
+  class CPVRClientCallJobs : public CJobWaiter
+  {
+  public:
+    typedef struct
+    {
+      int          iClientId;
+      PVR_ERROR    error;
+      unsigned int iDuration;
+    } Result;
+
+    CPVRClientCallJobs(unsigned int iJobs) : CJobWaiter(iJobs) {}
+    virtual ~CPVRClientCallJobs() {}
+
+    std::vector<Result> Results(void)
+    {
+      CSingleLock lock(m_section);
+      return m_results;
+    }
+
+  protected:
+    virtual void OnJobDone(unsigned int jobID, bool success, CJob *job)
+    {
+      CPVRClientCallJob *callJob = (CPVRClientCallJob *) job;
+      Result result = { callJob->m_client->GetID(), callJob->m_error, callJob->m_iDuration };
+      m_results.push_back(result);
+    }
+
+  private:
+    std::vector<Result> m_results;
+  };
+}
+
 CPVRClients::CPVRClients(void) :
     CThread("PVR add-on updater"),
     m_bChannelScanRunning(false),
@@ -165,6 +266,7 @@ void CPVRClients::Unload(void)
   m_strPlayingClientName = "";
 
   m_clientMap.clear();
+  m_callStats.clear();
 }
 
 int CPVRClients::GetFirstConnectedClientID(void)
@@ -375,23 +477,8 @@ bool CPVRClients::HasTimerSupport(int iClientId)
 
 PVR_ERROR CPVRClients::GetTimers(CPVRTimers *timers)
 {
-  PVR_ERROR error(PVR_ERROR_NO_ERROR);
-  PVR_CLIENTMAP clients;
-  GetConnectedClients(clients);
-
   /* get the timer list from each client */
-  for (PVR_CLIENTMAP_ITR itrClients = clients.begin(); itrClients != clients.end(); itrClients++)
-  {
-    PVR_ERROR currentError = (*itrClients).second->GetTimers(timers);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
-    {
-      CLog::Log(LOGERROR, "PVR - %s - cannot get timers from client '%d': %s",__FUNCTION__, (*itrClients).first, CPVRClient::ToString(currentError));
-      error = currentError;
-    }
-  }
-
-  return error;
+  return CallConnectedClients(PVR_CLIENT_CALL_GET_TIMERS, timers);
 }
 
 PVR_ERROR CPVRClients::AddTimer(const CPVRTimerInfoTag &timer)
@@ -449,22 +536,7 @@ PVR_ERROR CPVRClients::RenameTimer(const CPVRTimerInfoTag &timer, const CStdStri
 
 PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings)
 {
-  PVR_ERROR error(PVR_ERROR_NO_ERROR);
-  PVR_CLIENTMAP clients;
-  GetConnectedClients(clients);
-
-  for (PVR_CLIENTMAP_ITR itrClients = clients.begin(); itrClients != clients.end(); itrClients++)
-  {
-    PVR_ERROR currentError = (*itrClients).second->GetRecordings(recordings);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
-    {
-      CLog::Log(LOGERROR, "PVR - %s - cannot get recordings from client '%d': %s",__FUNCTION__, (*itrClients).first, CPVRClient::ToString(currentError));
-      error = currentError;
-    }
-  }
-
-  return error;
+  return CallConnectedClients(PVR_CLIENT_CALL_GET_RECORDINGS, recordings);
 }
 
 PVR_ERROR CPVRClients::RenameRecording(const CPVRRecording &recording)
@@ -595,26 +667,74 @@ PVR_ERROR CPVRClients::GetEPGForChannel(const CPVRChannel &channel, CEpg *epg, t
 }
 
 PVR_ERROR CPVRClients::GetChannels(CPVRChannelGroupInternal *group)
+{
+  /* get the channel list from each client */
+  return CallConnectedClients(PVR_CLIENT_CALL_GET_CHANNELS, group);
+}
+
+PVR_ERROR CPVRClients::CallConnectedClients(PVR_CLIENT_CALL call, void *data)
 {
   PVR_ERROR error(PVR_ERROR_NO_ERROR);
   PVR_CLIENTMAP clients;
   GetConnectedClients(clients);
 
-  /* get the channel list from each client */
+  /* one job per client. a single client is called directly, there's nothing to overlap */
+  CPVRClientCallJobs jobs(clients.size());
   for (PVR_CLIENTMAP_ITR itrClients = clients.begin(); itrClients != clients.end(); itrClients++)
   {
-    PVR_ERROR currentError = (*itrClients).second->GetChannels(*group, group->IsRadio());
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
+    CPVRClientCallJob *job = new CPVRClientCallJob((*itrClients).second, call, data);
+    if (clients.size() == 1 || !CJobManager::GetInstance().AddJob(job, &jobs, CJob::PRIORITY_HIGH))
     {
-      error = currentError;
-      CLog::Log(LOGERROR, "PVR - %s - cannot get channels from client '%d': %s",__FUNCTION__, (*itrClients).first, CPVRClient::ToString(error));
+      job->DoWork();
+      jobs.OnJobComplete(0, true, job);
+      delete job;
+    }
+  }
+
+  /* the clients transfer their data into the caller's container, so we can't give up on a call. keep
+     waiting, but tell the user which call is holding things up */
+  unsigned int iStart = XbmcThreads::SystemClockMillis();
+  while (!clients.empty() && !jobs.Wait(PVR_CLIENT_CALL_SLOW_TIME))
+    CLog::Log(LOGWARNING, "PVR - %s - still waiting for %s on %u client(s) after %u ms", __FUNCTION__,
+        CallToString(call), jobs.Remaining(), XbmcThreads::SystemClockMillis() - iStart);
+
+  std::vector<CPVRClientCallJobs::Result> results = jobs.Results();
+  for (std::vector<CPVRClientCallJobs::Result>::const_iterator it = results.begin(); it != results.end(); it++)
+  {
+    PVR_CLIENT_CALL_STATS stats = UpdateCallStats(it->iClientId, call, it->iDuration);
+    CLog::Log(it->iDuration >= PVR_CLIENT_CALL_SLOW_TIME ? LOGWARNING : LOGDEBUG,
+        "PVR - %s - %s on client '%d' took %u ms (%u calls, avg %u ms, max %u ms)", __FUNCTION__,
+        CallToString(call), it->iClientId, it->iDuration, stats.iCalls, stats.iTotalTime / stats.iCalls, stats.iMaxTime);
+
+    if (it->error != PVR_ERROR_NOT_IMPLEMENTED &&
+        it->error != PVR_ERROR_NO_ERROR)
+    {
+      CLog::Log(LOGERROR, "PVR - %s - %s failed on client '%d': %s", __FUNCTION__, CallToString(call), it->iClientId, CPVRClient::ToString(it->error));
+      error = it->error;
     }
   }
 
   return error;
 }
 
+PVR_CLIENT_CALL_STATS CPVRClients::UpdateCallStats(int iClientId, PVR_CLIENT_CALL call, unsigned int iDuration)
+{
+  CSingleLock lock(m_critSection);
+  std::map<std::pair<int, PVR_CLIENT_CALL>, PVR_CLIENT_CALL_STATS>::iterator it = m_callStats.find(std::make_pair(iClientId, call));
+  if (it == m_callStats.end())
+  {
+    PVR_CLIENT_CALL_STATS stats = { 0, 0, 0 };
+    it = m_callStats.insert(std::make_pair(std::make_pair(iClientId, call), stats)).first;
+  }
+
+  it->second.iCalls++;
+  it->second.iTotalTime += iDuration;
+  if (iDuration > it->second.iMaxTime)
+    it->second.iMaxTime = iDuration;
+
+  return it->second;
+}
+
 PVR_ERROR CPVRClients::GetChannelGroups(CPVRChannelGroups *groups)
 {
   PVR_ERROR error(PVR_ERROR_NO_ERROR);
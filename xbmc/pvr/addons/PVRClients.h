@@ -45,6 +45,26 @@ namespace PVR
   typedef std::map< int, PVR_STREAM_PROPERTIES >                         STREAMPROPS;
   typedef boost::shared_ptr<CPVRClient> PVR_CLIENT;
 
+  /*!
+   * @brief Calls that are sent to all connected clients at once, see CPVRClients::CallConnectedClients()
+   */
+  typedef enum
+  {
+    PVR_CLIENT_CALL_GET_CHANNELS,
+    PVR_CLIENT_CALL_GET_TIMERS,
+    PVR_CLIENT_CALL_GET_RECORDINGS
+  } PVR_CLIENT_CALL;
+
+  /*!
+   * @brief Latency statistics of a call on a client.
+   */
+  typedef struct
+  {
+    unsigned int iCalls;     /*!< the amount of calls made */
+    unsigned int iTotalTime; /*!< the total time spent in these calls in milliseconds */
+    unsigned int iMaxTime;   /*!< the slowest call in milliseconds */
+  } PVR_CLIENT_CALL_STATS;
+
   class CPVRClients : public ADDON::IAddonMgrCallback,
                       public Observer,
                       private CThread
@@ -625,6 +645,23 @@ namespace PVR
 
     int GetClientId(const ADDON::AddonPtr client) const;
 
+    /*!
+     * @brief Run a call on all connected clients, each client in its own job so slow backends don't hold up the others.
+     * @param call The call to make.
+     * @param data The container the clients transfer their data to. Must be safe to fill from several threads.
+     * @return The last error that was returned by a client, or PVR_ERROR_NO_ERROR if all calls succeeded.
+     */
+    PVR_ERROR CallConnectedClients(PVR_CLIENT_CALL call, void *data);
+
+    /*!
+     * @brief Add the duration of a call to the latency statistics of a client.
+     * @param iClientId The client that was called.
+     * @param call The call that was made.
+     * @param iDuration The duration of the call in milliseconds.
+     * @return The updated statistics.
+     */
+    PVR_CLIENT_CALL_STATS UpdateCallStats(int iClientId, PVR_CLIENT_CALL call, unsigned int iDuration);
+
     bool                  m_bChannelScanRunning;      /*!< true when a channel scan is currently running, false otherwise */
     bool                  m_bIsSwitchingChannels;        /*!< true while switching channels */
     bool                  m_bIsValidChannelSettings;  /*!< true if current channel settings are valid and can be saved */
@@ -640,5 +677,6 @@ namespace PVR
     CCriticalSection      m_critSection;
     CAddonDatabase        m_addonDb;
     std::map<int, time_t> m_connectionAttempts;       /*!< last connection attempt per add-on */
+    std::map<std::pair<int, PVR_CLIENT_CALL>, PVR_CLIENT_CALL_STATS> m_callStats; /*!< latency statistics per add-on and call */
   };
 }
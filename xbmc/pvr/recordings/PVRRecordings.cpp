@@ -43,9 +43,13 @@ CPVRRecordings::CPVRRecordings(void) :
 
 void CPVRRecordings::UpdateFromClients(void)
 {
+  /* the clients transfer their recordings from their own threads, so don't hold our lock while they do */
+  CPVRRecordings newRecordings;
+  g_PVRClients->GetRecordings(&newRecordings);
+
   CSingleLock lock(m_critSection);
   Clear();
-  g_PVRClients->GetRecordings(this);
+  m_recordings.swap(newRecordings.m_recordings);
 }
 
 CStdString CPVRRecordings::TrimSlashes(const CStdString &strOrig) const
@@ -113,6 +113,7 @@ void CAdvancedSettings::Initialize()
   m_videoFpsDetect = 1;
   m_videoDefaultLatency = 0.0;
   m_videoDisableHi10pMultithreading = false;
+  m_videoThumbExtractionJobs = 0; // 0 is one job per cpu
 
   m_musicUseTimeSeeking = true;
   m_musicTimeSeekForward = 10;
@@ -201,6 +202,8 @@ void CAdvancedSettings::Initialize()
   m_strMusicLibraryAlbumFormatRight = "";
   m_prioritiseAPEv2tags = false;
   m_musicItemSeparator = " / ";
+  m_musicTagReadThreads = 4;
+  m_bMusicLibraryFastHash = false;
   m_videoItemSeparator = " / ";
 
   m_bVideoLibraryHideAllItems = false;
@@ -213,6 +216,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
+  m_iVideoLibraryScraperThreads = 3;
 
   m_iTuxBoxStreamtsPort = 31339;
   m_bTuxBoxAudioChannelSelection = false;
@@ -291,6 +295,7 @@ void CAdvancedSettings::Initialize()
   m_iPVRMinVideoCacheLevel         = 5;
   m_iPVRMinAudioCacheLevel         = 10;
   m_bPVRCacheInDvdPlayer           = true;
+  m_bPVRFastChannelSwitch          = false;
   m_bPVRChannelIconsAutoScan       = true;
   m_bPVRAutoScanIconsUserSet       = false;
   m_iPVRNumericChannelSwitchTimeout = 1000;
@@ -298,6 +303,8 @@ void CAdvancedSettings::Initialize()
   m_measureRefreshrate = false;
 
   m_cacheMemBufferSize = 1024 * 1024 * 20;
+  m_directoryCacheSize = 1024 * 1024 * 8;
+  m_directoryCacheRevalidateAge = 300;
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
@@ -495,6 +502,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetFloat(pElement,"autoscalemaxfps",m_videoAutoScaleMaxFps, 0.0f, 1000.0f);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vdpau",m_videoAllowMpeg4VDPAU);
     XMLUtils::GetBoolean(pElement,"disablehi10pmultithreading",m_videoDisableHi10pMultithreading);
+    XMLUtils::GetInt(pElement, "thumbextractionjobs", m_videoThumbExtractionJobs, 0, 32);
     XMLUtils::GetBoolean(pElement,"allowmpeg4vaapi",m_videoAllowMpeg4VAAPI);    
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
@@ -636,6 +644,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
+    XMLUtils::GetInt(pElement, "tagreadthreads", m_musicTagReadThreads, 1, 16);
+    XMLUtils::GetBoolean(pElement, "fasthash", m_bMusicLibraryFastHash);
   }
 
   pElement = pRootElement->FirstChildElement("videolibrary");
@@ -651,6 +661,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "importwatchedstate", m_bVideoLibraryImportWatchedState);
     XMLUtils::GetBoolean(pElement, "importresumepoint", m_bVideoLibraryImportResumePoint);
     XMLUtils::GetInt(pElement, "dateadded", m_iVideoLibraryDateAdded);
+    XMLUtils::GetInt(pElement, "scraperthreads", m_iVideoLibraryScraperThreads, 1, 8);
   }
 
   pElement = pRootElement->FirstChildElement("videoscanner");
@@ -681,6 +692,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "curlretries", m_curlretries, 0, 10);
     XMLUtils::GetBoolean(pElement,"disableipv6", m_curlDisableIPV6);
     XMLUtils::GetUInt(pElement, "cachemembuffersize", m_cacheMemBufferSize);
+    XMLUtils::GetUInt(pElement, "directorycachesize", m_directoryCacheSize);
+    XMLUtils::GetUInt(pElement, "directorycacherevalidate", m_directoryCacheRevalidateAge);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -974,6 +987,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pPVR, "minvideocachelevel", m_iPVRMinVideoCacheLevel, 0, 100);
     XMLUtils::GetInt(pPVR, "minaudiocachelevel", m_iPVRMinAudioCacheLevel, 0, 100);
     XMLUtils::GetBoolean(pPVR, "cacheindvdplayer", m_bPVRCacheInDvdPlayer);
+    XMLUtils::GetBoolean(pPVR, "fastchannelswitch", m_bPVRFastChannelSwitch);
     XMLUtils::GetBoolean(pPVR, "channeliconsautoscan", m_bPVRChannelIconsAutoScan);
     XMLUtils::GetBoolean(pPVR, "autoscaniconsuserset", m_bPVRAutoScanIconsUserSet);
     XMLUtils::GetInt(pPVR, "numericchannelswitchtimeout", m_iPVRNumericChannelSwitchTimeout, 50, 60000);
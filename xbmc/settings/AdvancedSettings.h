@@ -165,6 +165,7 @@ class CAdvancedSettings
     bool m_DXVANoDeintProcForProgressive;
     int  m_videoFpsDetect;
     bool m_videoDisableHi10pMultithreading;
+    int  m_videoThumbExtractionJobs;
 
     CStdString m_videoDefaultPlayer;
     CStdString m_videoDefaultDVDPlayer;
@@ -236,6 +237,8 @@ class CAdvancedSettings
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
     CStdString m_musicItemSeparator;
+    int m_musicTagReadThreads;
+    bool m_bMusicLibraryFastHash;
     CStdString m_videoItemSeparator;
     std::vector<CStdString> m_musicTagsFromFileFilters;
 
@@ -250,6 +253,7 @@ class CAdvancedSettings
 
     bool m_bVideoScannerIgnoreErrors;
     int m_iVideoLibraryDateAdded;
+    int m_iVideoLibraryScraperThreads;
 
     std::vector<CStdString> m_vecTokens; // cleaning strings tied to language
     //TuxBox
@@ -331,6 +335,7 @@ class CAdvancedSettings
     int m_iPVRMinVideoCacheLevel;      /*!< @brief cache up to this level in the video buffer buffer before resuming playback if the buffers run dry */
     int m_iPVRMinAudioCacheLevel;      /*!< @brief cache up to this level in the audio buffer before resuming playback if the buffers run dry */
     bool m_bPVRCacheInDvdPlayer; /*!< @brief true to use "CACHESTATE_PVR" in CDVDPlayer (default) */
+    bool m_bPVRFastChannelSwitch; /*!< @brief true to reuse compatible decoders and show the first picture without waiting for the pvr cache after a channel switch. defaults to false. */
     bool m_bPVRChannelIconsAutoScan; /*!< @brief automatically scan user defined folder for channel icons when loading internal channel groups */
     bool m_bPVRAutoScanIconsUserSet; /*!< @brief mark channel icons populated by auto scan as "user set" */
     int m_iPVRNumericChannelSwitchTimeout; /*!< @brief time in ms before the numeric dialog auto closes when confirmchannelswitch is disabled */
@@ -349,6 +354,8 @@ class CAdvancedSettings
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
+    unsigned int m_directoryCacheSize;          ///< memory budget of the directory cache in bytes
+    unsigned int m_directoryCacheRevalidateAge; ///< age in seconds after which cached listings are refreshed (0 = never)
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
@@ -21,6 +21,7 @@
 #include "FileItem.h"
 #include "URL.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Variant.h"
 
 #include "gtest/gtest.h"
 
@@ -112,3 +113,35 @@ TEST(TestFileItem, GetBaseMoviePath)
     EXPECT_EQ(path, compare);
   }
 }
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasProperties());
+
+  item.SetProperty("Zeta", 1);
+  item.SetProperty("alpha", "a");
+  item.SetProperty("Mid", 2.5);
+  EXPECT_TRUE(item.HasProperties());
+
+  // keys are case insensitive
+  EXPECT_TRUE(item.HasProperty("ALPHA"));
+  EXPECT_STREQ("a", item.GetProperty("Alpha").asString().c_str());
+  item.SetProperty("ZETA", 3);
+  EXPECT_EQ(3, item.GetProperty("zeta").asInteger());
+
+  item.IncrementProperty("mid", 1.0);
+  EXPECT_DOUBLE_EQ(3.5, item.GetProperty("Mid").asDouble());
+
+  item.ClearProperty("mId");
+  EXPECT_FALSE(item.HasProperty("mid"));
+  EXPECT_TRUE(item.GetProperty("mid").isNull());
+  EXPECT_TRUE(item.HasProperty("zeta"));
+
+  CFileItem copy(item);
+  EXPECT_EQ(3, copy.GetProperty("Zeta").asInteger());
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(copy.HasProperty("alpha"));
+}
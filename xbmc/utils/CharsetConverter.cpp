@@ -24,6 +24,7 @@
 #include "LangInfo.h"
 #include "threads/SingleLock.h"
 #include "log.h"
+#include "utils/EndianSwap.h"
 
 #include <errno.h>
 #include <iconv.h>
@@ -59,10 +60,6 @@ static iconv_t m_iconvUtf8ToStringCharset        = (iconv_t)-1;
 static iconv_t m_iconvStringCharsetToUtf8        = (iconv_t)-1;
 static iconv_t m_iconvUcs2CharsetToStringCharset = (iconv_t)-1;
 static iconv_t m_iconvUtf32ToStringCharset       = (iconv_t)-1;
-static iconv_t m_iconvWtoUtf8                    = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoW                 = (iconv_t)-1;
-static iconv_t m_iconvUtf16BEtoUtf8              = (iconv_t)-1;
-static iconv_t m_iconvUtf16LEtoUtf8              = (iconv_t)-1;
 static iconv_t m_iconvUtf8toW                    = (iconv_t)-1;
 static iconv_t m_iconvUcs2CharsetToUtf8          = (iconv_t)-1;
 
@@ -273,6 +270,212 @@ static void convert(iconv_t& type, int multiplier, const CStdString& strFromChar
 
 using namespace std;
 
+/*
+ * Conversions between UTF-8, UTF-16 and wchar_t are done natively rather than
+ * through iconv. They're the hot path (every label shown goes through utf8ToW),
+ * need no shared conversion handle and therefore no lock. Invalid sequences are
+ * skipped, the same as convert() does for EILSEQ, and the result ends at the
+ * first NUL just like a converted CStdString would.
+ */
+
+// length of a UTF-8 sequence by its lead byte, 0 for bytes that can't start one
+// (continuation bytes, the overlong leads 0xC0/0xC1 and anything above U+10FFFF)
+static const unsigned char utf8SequenceLength[256] =
+{
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,  1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,  0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+  0, 0, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,  2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2,
+  3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,  4, 4, 4, 4, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+// smallest code point that may be encoded with a sequence of the given length
+static const uint32_t utf8MinimumCodepoint[5] = { 0, 0, 0x80, 0x800, 0x10000 };
+
+#define ASCII_WORD_MASK 0x8080808080808080ULL
+
+// tests a machine word at a time whether any byte has its high bit set
+static inline bool isAsciiBlock(const unsigned char *str)
+{
+  uint64_t word;
+  memcpy(&word, str, sizeof(word));
+  return (word & ASCII_WORD_MASK) == 0;
+}
+
+static size_t asciiPrefixLength(const char *str, size_t length)
+{
+  const unsigned char *s = (const unsigned char*)str;
+  size_t i = 0;
+  while (i + sizeof(uint64_t) <= length && isAsciiBlock(s + i))
+    i += sizeof(uint64_t);
+  while (i < length && s[i] < 0x80)
+    i++;
+  return i;
+}
+
+template<class WSTRING>
+static inline void appendWide(WSTRING &dest, uint32_t codepoint)
+{
+  typedef typename WSTRING::value_type CHAR;
+  if (sizeof(CHAR) == 2 && codepoint >= 0x10000)
+  {
+    codepoint -= 0x10000;
+    dest.push_back((CHAR)(0xD800 | (codepoint >> 10)));
+    dest.push_back((CHAR)(0xDC00 | (codepoint & 0x3FF)));
+  }
+  else
+    dest.push_back((CHAR)codepoint);
+}
+
+static inline void appendUtf8(CStdStringA &dest, uint32_t codepoint)
+{
+  if (codepoint < 0x80)
+    dest.push_back((char)codepoint);
+  else if (codepoint < 0x800)
+  {
+    dest.push_back((char)(0xC0 | (codepoint >> 6)));
+    dest.push_back((char)(0x80 | (codepoint & 0x3F)));
+  }
+  else if (codepoint < 0x10000)
+  {
+    dest.push_back((char)(0xE0 | (codepoint >> 12)));
+    dest.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+    dest.push_back((char)(0x80 | (codepoint & 0x3F)));
+  }
+  else
+  {
+    dest.push_back((char)(0xF0 | (codepoint >> 18)));
+    dest.push_back((char)(0x80 | ((codepoint >> 12) & 0x3F)));
+    dest.push_back((char)(0x80 | ((codepoint >> 6) & 0x3F)));
+    dest.push_back((char)(0x80 | (codepoint & 0x3F)));
+  }
+}
+
+static inline bool isValidCodepoint(uint32_t codepoint)
+{
+  return codepoint <= 0x10FFFF && (codepoint < 0xD800 || codepoint > 0xDFFF);
+}
+
+static void utf8ToWNative(const CStdStringA &strSource, CStdStringW &strDest)
+{
+  const unsigned char *s   = (const unsigned char*)strSource.c_str();
+  const unsigned char *end = s + strlen(strSource.c_str());
+
+  strDest.clear();
+  strDest.reserve(end - s);
+  while (s < end)
+  {
+    // runs of plain ascii are copied a word at a time
+    while (end - s >= (ptrdiff_t)sizeof(uint64_t) && isAsciiBlock(s))
+    {
+      for (size_t i = 0; i < sizeof(uint64_t); i++)
+        strDest.push_back((wchar_t)s[i]);
+      s += sizeof(uint64_t);
+    }
+    if (s == end)
+      break;
+
+    unsigned int length = utf8SequenceLength[*s];
+    if (length == 1)
+    {
+      strDest.push_back((wchar_t)*s++);
+      continue;
+    }
+    if (length == 0 || end - s < (ptrdiff_t)length)
+    {
+      s++; // skip the invalid byte
+      continue;
+    }
+
+    uint32_t codepoint = *s & (0xFF >> (length + 1));
+    unsigned int i;
+    for (i = 1; i < length && (s[i] & 0xC0) == 0x80; i++)
+      codepoint = (codepoint << 6) | (s[i] & 0x3F);
+
+    if (i < length || codepoint < utf8MinimumCodepoint[length] || !isValidCodepoint(codepoint))
+    {
+      s++; // skip the invalid lead byte, the rest is looked at on its own
+      continue;
+    }
+    appendWide(strDest, codepoint);
+    s += length;
+  }
+}
+
+static void wToUtf8Native(const CStdStringW &strSource, CStdStringA &strDest)
+{
+  const wchar_t *s = strSource.c_str();
+
+  strDest.clear();
+  strDest.reserve(strSource.length());
+  for (; *s; s++)
+  {
+    uint32_t codepoint = (uint32_t)*s;
+    if (sizeof(wchar_t) == 2)
+    {
+      codepoint &= 0xFFFF;
+      if (codepoint >= 0xD800 && codepoint <= 0xDBFF && s[1] >= 0xDC00 && s[1] <= 0xDFFF)
+      {
+        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (s[1] - 0xDC00);
+        s++;
+      }
+    }
+    if (!isValidCodepoint(codepoint))
+      continue; // unpaired surrogate or out of range, skip it
+    appendUtf8(strDest, codepoint);
+  }
+}
+
+// reads the next code point from a UTF-16 string of the given byte order,
+// returns false for an unpaired surrogate which the caller should skip
+static inline bool readUtf16(const uint16_t *&s, bool bigEndian, uint32_t &codepoint)
+{
+  codepoint = bigEndian ? Endian_SwapBE16(*s) : Endian_SwapLE16(*s);
+  s++;
+  if (codepoint < 0xD800 || codepoint > 0xDFFF)
+    return true;
+  if (codepoint >= 0xDC00)
+    return false;
+
+  uint32_t low = bigEndian ? Endian_SwapBE16(*s) : Endian_SwapLE16(*s);
+  if (low < 0xDC00 || low > 0xDFFF)
+    return false;
+  s++;
+  codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+  return true;
+}
+
+static void utf16ToUtf8Native(const CStdString16 &strSource, bool bigEndian, CStdStringA &strDest)
+{
+  const uint16_t *s = strSource.c_str();
+
+  strDest.clear();
+  strDest.reserve(strSource.length());
+  while (*s)
+  {
+    uint32_t codepoint;
+    if (readUtf16(s, bigEndian, codepoint))
+      appendUtf8(strDest, codepoint);
+  }
+}
+
+static void utf16ToWNative(const CStdString16 &strSource, bool bigEndian, CStdStringW &strDest)
+{
+  const uint16_t *s = strSource.c_str();
+
+  strDest.clear();
+  strDest.reserve(strSource.length());
+  while (*s)
+  {
+    uint32_t codepoint;
+    if (readUtf16(s, bigEndian, codepoint))
+      appendWide(strDest, codepoint);
+  }
+}
+
 static void logicalToVisualBiDi(const CStdStringA& strSource, CStdStringA& strDest, FriBidiCharSet fribidiCharset, FriBidiCharType base = FRIBIDI_TYPE_LTR, bool* bWasFlipped =NULL)
 {
   // libfribidi is not threadsafe, so make sure we make it so
@@ -393,9 +596,6 @@ void CCharsetConverter::reset(void)
   ICONV_SAFE_CLOSE(m_iconvStringCharsetToUtf8);
   ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToStringCharset);
   ICONV_SAFE_CLOSE(m_iconvSubtitleCharsetToW);
-  ICONV_SAFE_CLOSE(m_iconvWtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16BEtoUtf8);
-  ICONV_SAFE_CLOSE(m_iconvUtf16LEtoUtf8);
   ICONV_SAFE_CLOSE(m_iconvUtf32ToStringCharset);
   ICONV_SAFE_CLOSE(m_iconvUtf8toW);
   ICONV_SAFE_CLOSE(m_iconvUcs2CharsetToUtf8);
@@ -415,20 +615,34 @@ void CCharsetConverter::reset(void)
 // of the string is already made or the string is not displayed in the GUI
 void CCharsetConverter::utf8ToW(const CStdStringA& utf8String, CStdStringW &wString, bool bVisualBiDiFlip/*=true*/, bool forceLTRReadingOrder /*=false*/, bool* bWasFlipped/*=NULL*/)
 {
+  // Plain ascii has nothing to flip, so fribidi and its lock can be skipped. Multiline strings
+  // still take the long way as logicalToVisualBiDi() joins the lines.
+  size_t length = strlen(utf8String.c_str());
+  if (asciiPrefixLength(utf8String.c_str(), length) == length &&
+      (!bVisualBiDiFlip || !memchr(utf8String.c_str(), '\n', length)))
+  {
+    if (bVisualBiDiFlip && bWasFlipped)
+      *bWasFlipped = false;
+    utf8ToWNative(utf8String, wString);
+    return;
+  }
+
   // Try to flip hebrew/arabic characters, if any
+  CStdStringA strFlipped;
   if (bVisualBiDiFlip)
   {
-    CStdStringA strFlipped;
     FriBidiCharType charset = forceLTRReadingOrder ? FRIBIDI_TYPE_LTR : FRIBIDI_TYPE_PDF;
     logicalToVisualBiDi(utf8String, strFlipped, FRIBIDI_UTF8, charset, bWasFlipped);
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strFlipped,wString);
-  }
-  else
-  {
-    CSingleLock lock(m_critSection);
-    convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,utf8String,wString);
   }
+  const CStdStringA &strSource = bVisualBiDiFlip ? strFlipped : utf8String;
+
+#if defined(TARGET_DARWIN)
+  // UTF-8-MAC also composes decomposed characters, leave that to iconv
+  CSingleLock lock(m_critSection);
+  convert(m_iconvUtf8toW,sizeof(wchar_t),UTF8_SOURCE,WCHAR_CHARSET,strSource,wString);
+#else
+  utf8ToWNative(strSource, wString);
+#endif
 }
 
 void CCharsetConverter::subtitleCharsetToW(const CStdStringA& strSource, CStdStringW& strDest)
@@ -528,23 +742,18 @@ void CCharsetConverter::unknownToUTF8(const CStdStringA &source, CStdStringA &de
 
 void CCharsetConverter::wToUTF8(const CStdStringW& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  convert(m_iconvWtoUtf8,UTF8_DEST_MULTIPLIER,WCHAR_CHARSET,"UTF-8",strSource,strDest);
+  wToUtf8Native(strSource, strDest);
 }
 
 void CCharsetConverter::utf16BEtoUTF8(const CStdString16& strSource, CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16BEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16BE","UTF-8",strSource,strDest))
-    strDest.clear();
+  utf16ToUtf8Native(strSource, true, strDest);
 }
 
 void CCharsetConverter::utf16LEtoUTF8(const CStdString16& strSource,
                                       CStdStringA &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoUtf8,UTF8_DEST_MULTIPLIER,"UTF-16LE","UTF-8",strSource,strDest))
-    strDest.clear();
+  utf16ToUtf8Native(strSource, false, strDest);
 }
 
 void CCharsetConverter::ucs2ToUTF8(const CStdString16& strSource, CStdStringA& strDest)
@@ -556,9 +765,7 @@ void CCharsetConverter::ucs2ToUTF8(const CStdString16& strSource, CStdStringA& s
 
 void CCharsetConverter::utf16LEtoW(const CStdString16& strSource, CStdStringW &strDest)
 {
-  CSingleLock lock(m_critSection);
-  if(!convert_checked(m_iconvUtf16LEtoW,sizeof(wchar_t),"UTF-16LE",WCHAR_CHARSET,strSource,strDest))
-    strDest.clear();
+  utf16ToWNative(strSource, false, strDest);
 }
 
 void CCharsetConverter::ucs2CharsetToStringCharset(const CStdStringW& strSource, CStdStringA& strDest, bool swap)
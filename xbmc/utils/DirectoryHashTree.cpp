@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DirectoryHashTree.h"
+
+CDirectoryHashTree::CDirectoryHashTree()
+{
+  m_size = 0;
+}
+
+void CDirectoryHashTree::Clear()
+{
+  m_children.clear();
+  m_size = 0;
+}
+
+void CDirectoryHashTree::Add(const std::string &path, const std::string &hash)
+{
+  std::string parent = GetParent(path);
+  if (parent.empty())
+    return;
+
+  m_children[parent].push_back(make_pair(path, hash));
+  m_size++;
+}
+
+bool CDirectoryHashTree::GetSubDirectories(const std::string &path, const std::string &prefix, std::vector<std::string> &subdirs) const
+{
+  subdirs.clear();
+
+  std::map<std::string, Children>::const_iterator it = m_children.find(path);
+  if (it == m_children.end())
+    return true;
+
+  for (Children::const_iterator child = it->second.begin(); child != it->second.end(); ++child)
+  {
+    if (child->second.compare(0, prefix.size(), prefix) != 0)
+    {
+      subdirs.clear();
+      return false;
+    }
+    subdirs.push_back(child->first);
+  }
+  return true;
+}
+
+std::string CDirectoryHashTree::GetParent(const std::string &path)
+{
+  if (path.size() < 2)
+    return "";
+
+  // skip the trailing slash, and don't go up past the root of a protocol (eg smb://)
+  size_t pos = path.find_last_of("/\\", path.size() - 2);
+  size_t protocol = path.find("://");
+  if (pos == std::string::npos || (protocol != std::string::npos && pos <= protocol + 2))
+    return "";
+
+  return path.substr(0, pos + 1);
+}
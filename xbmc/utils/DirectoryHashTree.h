@@ -0,0 +1,70 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*! \brief Tree of the directories a library scanner has seen, as stored in the path table.
+
+ A directory's modification time only changes when entries are added to, removed from or
+ renamed within it, so when a directory's stored fast hash (based on that time) still matches,
+ the set of its subdirectories is the set recorded at the last scan. Such a directory need
+ not be listed at all: the scanner can descend straight into the subdirectories it knows of,
+ and an update of an unchanged source costs a stat per directory instead of a full listing.
+ */
+class CDirectoryHashTree
+{
+public:
+  CDirectoryHashTree();
+
+  void Clear();
+
+  /*! \brief Add a directory from the path table.
+   \param path the directory, with a trailing slash.
+   \param hash the hash stored for this directory.
+   */
+  void Add(const std::string &path, const std::string &hash);
+
+  /*! \brief Fetch the known subdirectories of a directory.
+   Only succeeds if every known subdirectory was stored with a hash starting with prefix,
+   as the entries of any other subdirectory can't be trusted without a listing.
+   \param path the directory, with a trailing slash.
+   \param prefix the prefix of the hashes that may be trusted, eg "fast".
+   \param subdirs [out] the subdirectories of path.
+   \return true if the subdirectories could be determined, false if path must be listed.
+   */
+  bool GetSubDirectories(const std::string &path, const std::string &prefix, std::vector<std::string> &subdirs) const;
+
+  unsigned int Size() const { return m_size; }
+
+  /*! \brief Get the parent of a directory by removing its last component.
+   \param path the directory, with a trailing slash.
+   \return the parent with a trailing slash, or an empty string if path has no parent.
+   */
+  static std::string GetParent(const std::string &path);
+
+private:
+  typedef std::vector<std::pair<std::string, std::string> > Children;
+  std::map<std::string, Children> m_children;
+  unsigned int m_size;
+};
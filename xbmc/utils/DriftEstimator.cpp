@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DriftEstimator.h"
+#include <math.h>
+
+// initial uncertainty of the drift, 1000ppm covers any sane clock
+#define INITIAL_DRIFT_DEVIATION 0.001
+// measurements further than this many standard deviations from the
+// prediction are rejected, unless they keep coming
+#define OUTLIER_DEVIATIONS 5.0
+#define OUTLIER_MAX_REJECTED 3
+
+CDriftEstimator::CDriftEstimator(double measurementNoise, double driftNoise)
+{
+  m_measurementVariance = measurementNoise * measurementNoise;
+  m_driftVariance = driftNoise * driftNoise;
+  Reset();
+}
+
+void CDriftEstimator::Reset()
+{
+  m_time = 0.0;
+  m_offset = 0.0;
+  m_drift = 0.0;
+  m_p[0][0] = m_p[0][1] = m_p[1][0] = m_p[1][1] = 0.0;
+  m_measurements = 0;
+  m_outliers = 0;
+  m_rejected = 0;
+  m_innovation = 0.0;
+}
+
+void CDriftEstimator::AddMeasurement(double time, double offset)
+{
+  if (m_measurements == 0)
+  {
+    m_time = time;
+    m_offset = offset;
+    m_drift = 0.0;
+    m_p[0][0] = m_measurementVariance;
+    m_p[0][1] = m_p[1][0] = 0.0;
+    m_p[1][1] = INITIAL_DRIFT_DEVIATION * INITIAL_DRIFT_DEVIATION;
+    m_innovation = 0.0;
+    m_measurements = 1;
+    return;
+  }
+
+  double dt = time - m_time;
+  if (dt < 0.0)
+    dt = 0.0;
+
+  // predict, the drift is a random walk with spectral density q
+  double q = m_driftVariance;
+  double p00 = m_p[0][0] + dt * (m_p[1][0] + m_p[0][1]) + dt * dt * m_p[1][1] + q * dt * dt * dt / 3.0;
+  double p01 = m_p[0][1] + dt * m_p[1][1] + q * dt * dt / 2.0;
+  double p10 = m_p[1][0] + dt * m_p[1][1] + q * dt * dt / 2.0;
+  double p11 = m_p[1][1] + q * dt;
+  double predicted = m_offset + m_drift * dt;
+
+  double innovation = offset - predicted;
+  double s = p00 + m_measurementVariance;
+
+  // reject single spikes, but accept a persistent change so we don't lock up
+  if (innovation * innovation > OUTLIER_DEVIATIONS * OUTLIER_DEVIATIONS * s && m_rejected < OUTLIER_MAX_REJECTED)
+  {
+    m_rejected++;
+    m_outliers++;
+    m_innovation = innovation;
+    return;
+  }
+  m_rejected = 0;
+
+  // update
+  double k0 = p00 / s;
+  double k1 = p10 / s;
+
+  m_time = time;
+  m_offset = predicted + k0 * innovation;
+  m_drift += k1 * innovation;
+  m_p[0][0] = p00 - k0 * p00;
+  m_p[0][1] = p01 - k0 * p01;
+  m_p[1][0] = p10 - k1 * p00;
+  m_p[1][1] = p11 - k1 * p01;
+  m_innovation = innovation;
+  m_measurements++;
+}
+
+void CDriftEstimator::Correct(double amount)
+{
+  m_offset += amount;
+}
+
+double CDriftEstimator::GetOffset(double time) const
+{
+  return m_offset + m_drift * (time - m_time);
+}
+
+double CDriftEstimator::GetOffsetDeviation() const
+{
+  return sqrt(m_p[0][0]);
+}
+
+CDriftEstimator::Stats CDriftEstimator::GetStats() const
+{
+  Stats stats;
+  stats.measurements    = m_measurements;
+  stats.outliers        = m_outliers;
+  stats.offset          = m_offset;
+  stats.offsetDeviation = sqrt(m_p[0][0]);
+  stats.drift           = m_drift;
+  stats.driftDeviation  = sqrt(m_p[1][1]);
+  stats.innovation      = m_innovation;
+  return stats;
+}
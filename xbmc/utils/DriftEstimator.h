@@ -0,0 +1,105 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*! \brief Class to estimate the offset and drift between two clocks
+
+ Measurements are noisy samples of the offset e(t) between two clocks, for instance the audio
+ playing pts and the player clock. We model the offset as
+
+   e(t) = o + d*t
+
+ where the drift d follows a random walk, and estimate both o and d with a two state Kalman
+ filter. Compared to averaging the error over a fixed window this gives a usable offset after
+ a handful of samples, tracks slow drift without lag, and provides the uncertainty of both
+ estimates so callers can decide when the estimate is good enough to act upon.
+
+ Time and offset are in seconds, drift is dimensionless (seconds per second).
+ */
+class CDriftEstimator
+{
+public:
+  /*! \brief Statistics describing the internal state of the estimator */
+  struct Stats
+  {
+    unsigned int measurements;   ///< \brief number of measurements since the last reset
+    unsigned int outliers;       ///< \brief number of measurements rejected as outliers
+    double       offset;         ///< \brief estimated offset at the last measurement
+    double       offsetDeviation;///< \brief standard deviation of the offset estimate
+    double       drift;          ///< \brief estimated drift
+    double       driftDeviation; ///< \brief standard deviation of the drift estimate
+    double       innovation;     ///< \brief difference between the last measurement and its prediction
+  };
+
+  /*! \brief Construct a drift estimator
+   \param measurementNoise standard deviation of a single measurement, in seconds
+   \param driftNoise how quickly the drift is expected to change, in seconds per second per sqrt(second)
+   */
+  CDriftEstimator(double measurementNoise = 0.005, double driftNoise = 0.00001);
+
+  /*! \brief Forget all measurements */
+  void Reset();
+
+  /*! \brief Add a measurement of the offset
+   \param time the time of the measurement, must not decrease between calls
+   \param offset the measured offset
+   */
+  void AddMeasurement(double time, double offset);
+
+  /*! \brief Account for a correction applied to the offset outside of the estimator
+   Use this when a known amount was corrected (e.g. the clock was adjusted), so that the
+   drift estimate is kept.
+   \param amount the amount added to the offset
+   */
+  void Correct(double amount);
+
+  /*! \brief Whether at least one measurement has been added since the last reset */
+  bool IsValid() const { return m_measurements > 0; }
+
+  /*! \brief Estimated offset at the time of the last measurement */
+  double GetOffset() const { return m_offset; }
+
+  /*! \brief Predicted offset at the given time */
+  double GetOffset(double time) const;
+
+  /*! \brief Estimated drift */
+  double GetDrift() const { return m_drift; }
+
+  /*! \brief Standard deviation of the offset estimate */
+  double GetOffsetDeviation() const;
+
+  /*! \brief Retrieve the internal state of the estimator */
+  Stats GetStats() const;
+
+private:
+  double m_measurementVariance; ///< \brief R, variance of a measurement
+  double m_driftVariance;       ///< \brief q, spectral density of the drift random walk
+
+  double m_time;                ///< \brief time of the last measurement
+  double m_offset;              ///< \brief estimated offset
+  double m_drift;               ///< \brief estimated drift
+  double m_p[2][2];             ///< \brief covariance of (offset, drift)
+
+  unsigned int m_measurements;
+  unsigned int m_outliers;
+  unsigned int m_rejected;      ///< \brief number of consecutive rejected measurements
+  double m_innovation;
+};
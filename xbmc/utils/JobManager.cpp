@@ -101,6 +101,39 @@ void CJobQueue::OnJobComplete(unsigned int jobID, bool success, CJob *job)
   QueueNextJob();
 }
 
+CJobWaiter::CJobWaiter(unsigned int jobs) : m_remaining(jobs), m_done(true, jobs == 0)
+{
+}
+
+void CJobWaiter::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  bool done;
+  {
+    CSingleLock lock(m_section);
+    OnJobDone(jobID, success, job);
+    done = m_remaining > 0 && --m_remaining == 0;
+  }
+  // the waiter may be destroyed as soon as the event is set, so the lock must be released by now
+  if (done)
+    m_done.Set();
+}
+
+void CJobWaiter::Wait()
+{
+  m_done.Wait();
+}
+
+bool CJobWaiter::Wait(unsigned int milliSeconds)
+{
+  return m_done.WaitMSec(milliSeconds);
+}
+
+unsigned int CJobWaiter::Remaining() const
+{
+  CSingleLock lock(m_section);
+  return m_remaining;
+}
+
 void CJobQueue::CancelJob(const CJob *job)
 {
   CSingleLock lock(m_section);
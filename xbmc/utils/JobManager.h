@@ -24,6 +24,7 @@
 #include <string>
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
+#include "threads/Event.h"
 #include "Job.h"
 
 class CJobManager;
@@ -149,6 +150,61 @@ private:
   bool m_lifo;
 };
 
+/*!
+ \ingroup jobs
+ \brief Callback to wait for a fixed number of jobs to complete
+
+ Pass it as the callback of every job and Wait() for them. The waiter may be
+ destroyed as soon as Wait() returns, so it can live on the caller's stack.
+
+ Classes should subclass this class and override OnJobDone should they require
+ information from the jobs.
+
+ \sa CJob and IJobCallback
+ */
+class CJobWaiter : public IJobCallback
+{
+public:
+  /*!
+   \brief CJobWaiter constructor
+   \param jobs the number of jobs to wait for.
+   */
+  CJobWaiter(unsigned int jobs);
+  virtual ~CJobWaiter() {}
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /*!
+   \brief Wait until all jobs have completed
+   */
+  void Wait();
+
+  /*!
+   \brief Wait until all jobs have completed or the timeout expired
+   \param milliSeconds the time to wait at most.
+   \return true if all jobs have completed, false on timeout.
+   */
+  bool Wait(unsigned int milliSeconds);
+
+  /*!
+   \brief The number of jobs that haven't completed yet
+   */
+  unsigned int Remaining() const;
+
+protected:
+  /*!
+   \brief Called for each completed job, with m_section held
+   \sa IJobCallback::OnJobComplete
+   */
+  virtual void OnJobDone(unsigned int jobID, bool success, CJob *job) {};
+
+  mutable CCriticalSection m_section;
+
+private:
+  unsigned int m_remaining;
+  CEvent m_done;
+};
+
 /*!
  \ingroup jobs
  \brief Job Manager class for scheduling asynchronous jobs.
@@ -265,6 +321,14 @@ public:
    */
   bool IsProcessing(const CJob::PRIORITY &priority) const;
 
+  /*!
+   \brief The number of jobs of a priority that may be processed at once.
+   Lower priorities get fewer workers, so that higher priority jobs always find a free one.
+   \param priority the priority of the jobs.
+   \return the maximal number of workers for jobs of this priority.
+   */
+  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
+
 protected:
   friend class CJobWorker;
   friend class CJob;
@@ -310,7 +374,6 @@ private:
 
   void StartWorkers(CJob::PRIORITY priority);
   void RemoveWorker(const CJobWorker *worker);
-  unsigned int GetMaxWorkers(CJob::PRIORITY priority) const;
 
   unsigned int m_jobCounter;
 
@@ -23,12 +23,98 @@
 #include "RegExp.h"
 #include "StdString.h"
 #include "log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 
 using namespace PCRE;
 
+#define MAX_CACHED_PATTERNS 512
+
+/*! \brief A compiled and studied pattern.
+ pcre_exec() only reads it, so it is shared by every CRegExp using the same pattern and options.
+ */
+struct CRegExp::CompiledPattern
+{
+  CompiledPattern(pcre *re, pcre_extra *sd) : re(re), sd(sd) {}
+  ~CompiledPattern()
+  {
+    if (sd)
+#ifdef PCRE_STUDY_JIT_COMPILE
+      pcre_free_study(sd);
+#else
+      pcre_free(sd);
+#endif
+    pcre_free(re);
+  }
+
+  pcre       *re;
+  pcre_extra *sd;
+};
+
+static CCriticalSection &GetCacheSection()
+{
+  static CCriticalSection section;
+  return section;
+}
+
+CRegExp::PatternCache& CRegExp::GetCache()
+{
+  static PatternCache cache;
+  return cache;
+}
+
+CRegExp::CompiledPatternPtr CRegExp::GetCompiledPattern(const char *re, int options)
+{
+  std::pair<int, std::string> key(options, re);
+
+  CSingleLock lock(GetCacheSection());
+  PatternCache &cache = GetCache();
+  PatternCache::const_iterator it = cache.find(key);
+  if (it != cache.end())
+    return it->second;
+
+  const char *errMsg = NULL;
+  int errOffset      = 0;
+  pcre *compiled = pcre_compile(re, options, &errMsg, &errOffset, NULL);
+  if (!compiled)
+  {
+    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
+              errMsg, errOffset, re);
+    return CompiledPatternPtr();
+  }
+
+  // as the result is kept around, the time spent studying it is well invested
+  int studyOptions = 0;
+#ifdef PCRE_STUDY_JIT_COMPILE
+  studyOptions |= PCRE_STUDY_JIT_COMPILE;
+#endif
+  pcre_extra *studied = pcre_study(compiled, studyOptions, &errMsg);
+  if (errMsg)
+    CLog::Log(LOGWARNING, "PCRE: %s. Studying failed for expression '%s'", errMsg, re);
+
+  CompiledPatternPtr pattern(new CompiledPattern(compiled, studied));
+
+  // patterns only used by a since destroyed CRegExp make room for new ones
+  if (cache.size() >= MAX_CACHED_PATTERNS)
+  {
+    for (PatternCache::iterator i = cache.begin(); i != cache.end();)
+    {
+      if (i->second.unique())
+        cache.erase(i++);
+      else
+        ++i;
+    }
+  }
+  if (cache.size() < MAX_CACHED_PATTERNS)
+    cache.insert(std::make_pair(key, pattern));
+
+  return pattern;
+}
+
 CRegExp::CRegExp(bool caseless)
 {
   m_re          = NULL;
+  m_sd          = NULL;
   m_iOptions    = PCRE_DOTALL;
   if(caseless)
     m_iOptions |= PCRE_CASELESS;
@@ -42,29 +128,28 @@ CRegExp::CRegExp(bool caseless)
 CRegExp::CRegExp(const CRegExp& re)
 {
   m_re = NULL;
+  m_sd = NULL;
   m_iOptions = re.m_iOptions;
   *this = re;
 }
 
 const CRegExp& CRegExp::operator=(const CRegExp& re)
 {
-  size_t size;
+  if (&re == this)
+    return *this;
+
   Cleanup();
   m_pattern = re.m_pattern;
   if (re.m_re)
   {
-    if (pcre_fullinfo(re.m_re, NULL, PCRE_INFO_SIZE, &size) >= 0)
-    {
-      if ((m_re = (pcre*)malloc(size)))
-      {
-        memcpy(m_re, re.m_re, size);
-        memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
-        m_iMatchCount = re.m_iMatchCount;
-        m_bMatched = re.m_bMatched;
-        m_subject = re.m_subject;
-        m_iOptions = re.m_iOptions;
-      }
-    }
+    m_compiled = re.m_compiled;
+    m_re = re.m_re;
+    m_sd = re.m_sd;
+    memcpy(m_iOvector, re.m_iOvector, OVECCOUNT*sizeof(int));
+    m_iMatchCount = re.m_iMatchCount;
+    m_bMatched = re.m_bMatched;
+    m_subject = re.m_subject;
+    m_iOptions = re.m_iOptions;
   }
   return *this;
 }
@@ -81,25 +166,53 @@ CRegExp* CRegExp::RegComp(const char *re)
 
   m_bMatched         = false;
   m_iMatchCount      = 0;
-  const char *errMsg = NULL;
-  int errOffset      = 0;
 
   Cleanup();
 
-  m_re = pcre_compile(re, m_iOptions, &errMsg, &errOffset, NULL);
-  if (!m_re)
+  m_compiled = GetCompiledPattern(re, m_iOptions);
+  if (!m_compiled)
   {
     m_pattern.clear();
-    CLog::Log(LOGERROR, "PCRE: %s. Compilation failed at offset %d in expression '%s'",
-              errMsg, errOffset, re);
     return NULL;
   }
 
+  m_re = m_compiled->re;
+  m_sd = m_compiled->sd;
   m_pattern = re;
 
   return this;
 }
 
+CRegExp* CRegExp::RegCompAny(const std::vector<std::string>& patterns)
+{
+  std::string combined;
+  for (std::vector<std::string>::const_iterator it = patterns.begin(); it != patterns.end(); ++it)
+  {
+    // group numbers change once combined, and names may clash
+    for (size_t pos = it->find('\\'); pos != std::string::npos; pos = it->find('\\', pos + 2))
+    {
+      char next = pos + 1 < it->size() ? (*it)[pos + 1] : 0;
+      if ((next >= '1' && next <= '9') || next == 'g' || next == 'k')
+        return NULL;
+    }
+    for (size_t pos = it->find("(?"); pos != std::string::npos; pos = it->find("(?", pos + 2))
+    {
+      char next = pos + 2 < it->size() ? (*it)[pos + 2] : 0;
+      char after = pos + 3 < it->size() ? (*it)[pos + 3] : 0;
+      if (next == 'P' || next == '\'' || next == '|' || (next == '<' && after != '=' && after != '!'))
+        return NULL;
+    }
+
+    if (!combined.empty())
+      combined += "|";
+    combined += "(?:" + *it + ")";
+  }
+  if (combined.empty())
+    return NULL;
+
+  return RegComp(combined);
+}
+
 int CRegExp::RegFind(const char* str, int startoffset)
 {
   m_bMatched    = false;
@@ -118,7 +231,7 @@ int CRegExp::RegFind(const char* str, int startoffset)
   }
 
   m_subject = str;
-  int rc = pcre_exec(m_re, NULL, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
+  int rc = pcre_exec(m_re, m_sd, str, strlen(str), startoffset, 0, m_iOvector, OVECCOUNT);
 
   if (rc<1)
   {
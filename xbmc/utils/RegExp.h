@@ -24,6 +24,8 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <boost/shared_ptr.hpp>
 
 namespace PCRE {
 #ifdef _WIN32
@@ -47,6 +49,11 @@ public:
 
   CRegExp* RegComp(const char *re);
   CRegExp* RegComp(const std::string& re) { return RegComp(re.c_str()); }
+  /*! \brief Compile a pattern matching wherever any of the given patterns matches
+   Lets a single pass over a string tell whether it is worth trying the patterns one by one.
+   Fails for patterns that can't be combined safely, i.e. those using backreferences or named groups.
+   */
+  CRegExp* RegCompAny(const std::vector<std::string>& patterns);
   int RegFind(const char *str, int startoffset = 0);
   int RegFind(const std::string& str, int startoffset = 0) { return RegFind(str.c_str(), startoffset); }
   std::string GetReplaceString( const char* sReplaceExp );
@@ -68,10 +75,18 @@ public:
   const CRegExp& operator= (const CRegExp& re);
 
 private:
-  void Cleanup() { if (m_re) { PCRE::pcre_free(m_re); m_re = NULL; } }
+  void Cleanup() { m_compiled.reset(); m_re = NULL; m_sd = NULL; }
+
+  struct CompiledPattern;
+  typedef boost::shared_ptr<CompiledPattern> CompiledPatternPtr;
+  typedef std::map<std::pair<int, std::string>, CompiledPatternPtr> PatternCache;
+  static CompiledPatternPtr GetCompiledPattern(const char *re, int options);
+  static PatternCache& GetCache();
 
 private:
+  CompiledPatternPtr m_compiled; // shared by all instances using the same pattern and options
   PCRE::pcre* m_re;
+  PCRE::pcre_extra* m_sd;
   int         m_iOvector[OVECCOUNT];
   int         m_iMatchCount;
   int         m_iOptions;
@@ -196,35 +196,69 @@ unsigned int CScraperUrl::GetMaxSeasonThumb() const
   return maxSeason;
 }
 
-bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCurlFile& http, const CStdString& cacheContext)
+static bool GetCached(const CScraperUrl::SUrlEntry& scrURL, std::string& strHTML, const CStdString& cacheContext)
 {
-  CURL url(scrURL.m_url);
-  http.SetReferer(scrURL.m_spoof);
+  if (scrURL.m_cache.IsEmpty())
+    return false;
+
   CStdString strCachePath;
+  URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath,
+                            "scrapers/"+cacheContext+"/"+scrURL.m_cache,
+                            strCachePath);
+  if (XFILE::CFile::Exists(strCachePath))
+  {
+    XFILE::CFile file;
+    if (file.Open(strCachePath))
+    {
+      char* temp = new char[(int)file.GetLength()];
+      file.Read(temp,file.GetLength());
+      strHTML.clear();
+      strHTML.append(temp,temp+file.GetLength());
+      file.Close();
+      delete[] temp;
+      return true;
+    }
+  }
+  return false;
+}
 
-  if (scrURL.m_isgz)
-    http.SetContentEncoding("gzip");
+static void ProcessFetched(const CScraperUrl::SUrlEntry& scrURL, std::string& strHTML, const CStdString& cacheContext)
+{
+  if (scrURL.m_url.Find(".zip") > -1 )
+  {
+    XFILE::CZipFile file;
+    CStdString strBuffer;
+    int iSize = file.UnpackFromMemory(strBuffer,strHTML,scrURL.m_isgz);
+    if (iSize)
+    {
+      strHTML.clear();
+      strHTML.append(strBuffer.c_str(),strBuffer.data()+iSize);
+    }
+  }
 
   if (!scrURL.m_cache.IsEmpty())
   {
+    CStdString strCachePath;
     URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath,
                               "scrapers/"+cacheContext+"/"+scrURL.m_cache,
                               strCachePath);
-    if (XFILE::CFile::Exists(strCachePath))
-    {
-      XFILE::CFile file;
-      if (file.Open(strCachePath))
-      {
-        char* temp = new char[(int)file.GetLength()];
-        file.Read(temp,file.GetLength());
-        strHTML.clear();
-        strHTML.append(temp,temp+file.GetLength());
-        file.Close();
-        delete[] temp;
-        return true;
-      }
-    }
+    XFILE::CFile file;
+    if (file.OpenForWrite(strCachePath,true))
+      file.Write(strHTML.data(),strHTML.size());
+    file.Close();
   }
+}
+
+bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCurlFile& http, const CStdString& cacheContext)
+{
+  CURL url(scrURL.m_url);
+  http.SetReferer(scrURL.m_spoof);
+
+  if (scrURL.m_isgz)
+    http.SetContentEncoding("gzip");
+
+  if (GetCached(scrURL, strHTML, cacheContext))
+    return true;
 
   CStdString strHTML1(strHTML);
 
@@ -243,28 +277,52 @@ bool CScraperUrl::Get(const SUrlEntry& scrURL, std::string& strHTML, XFILE::CCur
 
   strHTML = strHTML1;
 
-  if (scrURL.m_url.Find(".zip") > -1 )
+  ProcessFetched(scrURL, strHTML, cacheContext);
+  return true;
+}
+
+bool CScraperUrl::Get(const std::vector<SUrlEntry>& scrURLs, std::vector<std::string>& strHTMLs, XFILE::CCurlFile& http,
+                      const CStdString& cacheContext)
+{
+  strHTMLs.assign(scrURLs.size(), "");
+
+  // posts and cached pages are handled one by one, the rest is fetched at once
+  std::vector<CStdString> urls;
+  std::vector<unsigned int> fetch;
+  for (unsigned int i = 0; i < scrURLs.size(); ++i)
   {
-    XFILE::CZipFile file;
-    CStdString strBuffer;
-    int iSize = file.UnpackFromMemory(strBuffer,strHTML,scrURL.m_isgz);
-    if (iSize)
+    const SUrlEntry& scrURL = scrURLs[i];
+    if (scrURL.m_post)
     {
-      strHTML.clear();
-      strHTML.append(strBuffer.c_str(),strBuffer.data()+iSize);
+      if (!Get(scrURL, strHTMLs[i], http, cacheContext))
+        return false;
+    }
+    else if (!GetCached(scrURL, strHTMLs[i], cacheContext))
+    {
+      // referrer and encoding are passed as protocol options, as they differ per url
+      CStdString url = GetThumbURL(scrURL);
+      if (scrURL.m_isgz)
+        url += (url.Find('|') > -1 ? "&" : "|") + CStdString("Encoding=gzip");
+      urls.push_back(url);
+      fetch.push_back(i);
     }
   }
 
-  if (!scrURL.m_cache.IsEmpty())
+  if (fetch.size() == 1)
+    return Get(scrURLs[fetch[0]], strHTMLs[fetch[0]], http, cacheContext);
+
+  if (fetch.empty())
+    return true;
+
+  http.SetReferer("");
+  std::vector<CStdString> results;
+  if (!http.GetBatch(urls, results))
+    return false;
+
+  for (unsigned int i = 0; i < fetch.size(); ++i)
   {
-    CStdString strCachePath;
-    URIUtils::AddFileToFolder(g_advancedSettings.m_cachePath,
-                              "scrapers/"+cacheContext+"/"+scrURL.m_cache,
-                              strCachePath);
-    XFILE::CFile file;
-    if (file.OpenForWrite(strCachePath,true))
-      file.Write(strHTML.data(),strHTML.size());
-    file.Close();
+    strHTMLs[fetch[i]] = results[i];
+    ProcessFetched(scrURLs[fetch[i]], strHTMLs[fetch[i]], cacheContext);
   }
   return true;
 }
@@ -78,6 +78,12 @@ public:
   void Clear();
   static bool Get(const SUrlEntry&, std::string&, XFILE::CCurlFile& http,
                  const CStdString& cacheContext);
+  /*! \brief fetch several URL entries, downloading the uncached ones concurrently
+   \param strHTMLs [out] the fetched data, in the order of the entries
+   \return true if all entries were fetched
+   */
+  static bool Get(const std::vector<SUrlEntry>&, std::vector<std::string>& strHTMLs, XFILE::CCurlFile& http,
+                 const CStdString& cacheContext);
 
   CStdString m_xml;
   CStdString m_spoof; // for backwards compatibility only!
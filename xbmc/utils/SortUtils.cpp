@@ -416,38 +416,62 @@ string ByDateTaken(SortAttribute attributes, const SortItem &values)
   return values.at(FieldDateTaken).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+/*! \brief Everything the sorters need to know about an item, extracted
+ once per item so that comparisons don't have to look up fields in the
+ SortItem or convert the sort label over and over again.
+ */
+typedef struct SortKey
+{
+  size_t index;
+  bool hasLabel;
+  SortSpecial special;
+  int folder; // -1 if unknown
+  std::wstring label;
+} SortKey;
+
+void fillSortKey(const SortItem &item, size_t index, SortKey &key)
+{
+  key.index = index;
+  key.special = SortSpecialNone;
+  key.folder = -1;
+
+  SortItem::const_iterator it;
+  if ((it = item.find(FieldSort)) != item.end())
+  {
+    key.hasLabel = true;
+    key.label = it->second.asWideString();
+  }
+  else
+    key.hasLabel = false;
+
+  if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    key.special = (SortSpecial)it->second.asInteger();
+  if ((it = item.find(FieldFolder)) != item.end())
+    key.folder = it->second.asBoolean() ? 1 : 0;
+}
+
+bool preliminarySort(const SortKey &left, const SortKey &right, bool handleFolder, bool &result)
 {
   // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
+  if (!left.hasLabel)
   {
     result = false;
     return true;
   }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+  if (!right.hasLabel)
   {
     result = true;
     return true;
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-  
   // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  if (left.special != right.special)
   {
     // left should be sorted on top
     // or right should be sorted on bottom
     // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    if (left.special == SortSpecialOnTop ||
+        right.special == SortSpecialOnBottom)
     {
       result = true;
       return true;
@@ -458,68 +482,56 @@ bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFol
     return true;
   }
   // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+  else if (left.special != SortSpecialNone)
   {
     result = false;
     return true;
   }
 
-  if (handleFolder)
+  if (handleFolder && left.folder >= 0 && right.folder >= 0 &&
+      left.folder != right.folder)
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
-    {
-      result = itLeft->second.asBoolean();
-      return true;
-    }
+    result = left.folder == 1;
+    return true;
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
-
   return false;
 }
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+bool SorterAscending(const SortKey *left, const SortKey *right)
 {
   bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
+  if (preliminarySort(*left, *right, true, result))
     return result;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+  return StringUtils::AlphaNumericCompare(left->label.c_str(), right->label.c_str()) < 0;
 }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
+bool SorterDescending(const SortKey *left, const SortKey *right)
 {
   bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
+  if (preliminarySort(*left, *right, true, result))
     return result;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  return StringUtils::AlphaNumericCompare(left->label.c_str(), right->label.c_str()) > 0;
 }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
+bool SorterIgnoreFoldersAscending(const SortKey *left, const SortKey *right)
 {
   bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
+  if (preliminarySort(*left, *right, false, result))
     return result;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
+  return StringUtils::AlphaNumericCompare(left->label.c_str(), right->label.c_str()) < 0;
 }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
+bool SorterIgnoreFoldersDescending(const SortKey *left, const SortKey *right)
 {
   bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
+  if (preliminarySort(*left, *right, false, result))
     return result;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  return StringUtils::AlphaNumericCompare(left->label.c_str(), right->label.c_str()) > 0;
 }
 
 map<SortBy, SortUtils::SortPreparator> fillPreparators()
@@ -674,8 +686,24 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
         item->insert(pair<Field, CVariant>(FieldSort, CVariant(sortLabel)));
       }
 
+      // Extract the sort keys once and sort pointers to them instead of
+      // moving the (map based) items around on every swap
+      vector<SortKey> keys(items.size());
+      vector<const SortKey*> sortedKeys(items.size());
+      for (size_t i = 0; i < items.size(); i++)
+      {
+        fillSortKey(items[i], i, keys[i]);
+        sortedKeys[i] = &keys[i];
+      }
+
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      std::stable_sort(sortedKeys.begin(), sortedKeys.end(), getSorter(sortOrder, attributes));
+
+      // Put the items into their sorted order (swapping maps is cheap)
+      SortItems sortedItems(items.size());
+      for (size_t i = 0; i < sortedKeys.size(); i++)
+        sortedItems[i].swap(items[sortedKeys[i]->index]);
+      items.swap(sortedItems);
     }
   }
 
@@ -108,6 +108,8 @@ typedef struct SortDescription {
 typedef DatabaseResult SortItem;
 typedef DatabaseResults SortItems;
 
+struct SortKey;
+
 class SortUtils
 {
 public:
@@ -128,7 +130,7 @@ public:
   static std::string RemoveArticles(const std::string &label);
   
   typedef std::string (*SortPreparator) (SortAttribute, const SortItem&);
-  typedef bool (*Sorter) (const SortItem&, const SortItem&);
+  typedef bool (*Sorter) (const SortKey*, const SortKey*);
   
 private:
   static const SortPreparator& getPreparator(SortBy sortBy);
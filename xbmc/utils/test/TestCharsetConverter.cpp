@@ -263,6 +263,49 @@ TEST_F(TestCharsetConverter, utf16LEtoUTF8)
   EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
 }
 
+TEST_F(TestCharsetConverter, utf8ToW_SupplementaryPlanes)
+{
+  refstra1 = "a\xF0\x9F\x90\xAD" "b";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_EQ(sizeof(wchar_t) == 2 ? 4u : 3u, varstrw1.length());
+  varstra1.clear();
+  g_charsetConverter.wToUTF8(varstrw1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToW_InvalidSequences)
+{
+  /* stray continuation, overlong, surrogate and truncated sequences are skipped */
+  refstra1 = "te\x80st\xC0\xAF_\xED\xA0\x80utf8\xC3";
+  refstrw1 = L"test_utf8";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_STREQ(refstrw1.c_str(), varstrw1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf16LEtoUTF8_Surrogates)
+{
+  static const uint16_t surrogates[] = { 0x0041, 0xd83d, 0xdc2d, 0xdc00, 0x0042, 0xd83d, 0x0 };
+  refstr16_1.assign(surrogates);
+  refstra1 = "A\xF0\x9F\x90\xAD" "B";
+  varstra1.clear();
+  g_charsetConverter.utf16LEtoUTF8(refstr16_1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
+TEST_F(TestCharsetConverter, utf8ToW_RoundTrip)
+{
+  /* two, three and four byte sequences survive the conversion both ways */
+  refstra1 = "Am\xC3\xA9lie \xE5\x8D\x83\xE3\x81\xA8 \xF0\x9F\x90\xAD";
+  varstrw1.clear();
+  g_charsetConverter.utf8ToW(refstra1, varstrw1, false);
+  EXPECT_EQ(sizeof(wchar_t) == 2 ? 12u : 11u, varstrw1.length());
+  varstra1.clear();
+  g_charsetConverter.wToUTF8(varstrw1, varstra1);
+  EXPECT_STREQ(refstra1.c_str(), varstra1.c_str());
+}
+
 TEST_F(TestCharsetConverter, ucs2ToUTF8)
 {
   refstr16_1.assign(refucs2);
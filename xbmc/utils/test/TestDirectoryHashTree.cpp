@@ -0,0 +1,73 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/DirectoryHashTree.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestDirectoryHashTree, GetParent)
+{
+  EXPECT_STREQ("/mnt/music/", CDirectoryHashTree::GetParent("/mnt/music/album/").c_str());
+  EXPECT_STREQ("/", CDirectoryHashTree::GetParent("/mnt/").c_str());
+  EXPECT_STREQ("", CDirectoryHashTree::GetParent("/").c_str());
+  EXPECT_STREQ("smb://server/", CDirectoryHashTree::GetParent("smb://server/share/").c_str());
+  EXPECT_STREQ("", CDirectoryHashTree::GetParent("smb://server/").c_str());
+  EXPECT_STREQ("C:\\Music\\", CDirectoryHashTree::GetParent("C:\\Music\\Album\\").c_str());
+}
+
+TEST(TestDirectoryHashTree, GetSubDirectories)
+{
+  CDirectoryHashTree tree;
+  tree.Add("/mnt/music/", "fast100");
+  tree.Add("/mnt/music/a/", "fast200");
+  tree.Add("/mnt/music/b/", "fast300");
+  tree.Add("/mnt/music/b/cd1/", "fast400");
+  EXPECT_EQ(4U, tree.Size());
+
+  std::vector<std::string> subdirs;
+  EXPECT_TRUE(tree.GetSubDirectories("/mnt/music/", "fast", subdirs));
+  ASSERT_EQ(2U, subdirs.size());
+  EXPECT_STREQ("/mnt/music/a/", subdirs[0].c_str());
+  EXPECT_STREQ("/mnt/music/b/", subdirs[1].c_str());
+
+  EXPECT_TRUE(tree.GetSubDirectories("/mnt/music/b/", "fast", subdirs));
+  ASSERT_EQ(1U, subdirs.size());
+  EXPECT_STREQ("/mnt/music/b/cd1/", subdirs[0].c_str());
+
+  // leaves and unknown directories have no subdirectories
+  EXPECT_TRUE(tree.GetSubDirectories("/mnt/music/a/", "fast", subdirs));
+  EXPECT_TRUE(subdirs.empty());
+}
+
+TEST(TestDirectoryHashTree, UntrustedChild)
+{
+  CDirectoryHashTree tree;
+  tree.Add("/mnt/movies/a/", "fast200");
+  tree.Add("/mnt/movies/b/", "");
+  tree.Add("/mnt/movies/c/", "d41d8cd98f00b204e9800998ecf8427e");
+
+  std::vector<std::string> subdirs;
+  EXPECT_FALSE(tree.GetSubDirectories("/mnt/movies/", "fast", subdirs));
+  EXPECT_TRUE(subdirs.empty());
+
+  tree.Clear();
+  EXPECT_EQ(0U, tree.Size());
+  EXPECT_TRUE(tree.GetSubDirectories("/mnt/movies/", "fast", subdirs));
+}
@@ -0,0 +1,98 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/DriftEstimator.h"
+
+#include "gtest/gtest.h"
+
+/* simulated clock with a fixed offset and drift plus deterministic
+   measurement noise of +-5ms */
+static double SimulatedOffset(int i, double time, double offset, double drift)
+{
+  static const double noise[] = { 0.004, -0.003, 0.001, -0.005, 0.002, 0.005, -0.001, -0.004, 0.003, -0.002 };
+  return offset + drift * time + noise[i % 10];
+}
+
+TEST(TestDriftEstimator, Empty)
+{
+  CDriftEstimator a;
+  EXPECT_FALSE(a.IsValid());
+  EXPECT_EQ(0.0, a.GetOffset());
+  EXPECT_EQ(0.0, a.GetDrift());
+}
+
+TEST(TestDriftEstimator, ConstantOffset)
+{
+  CDriftEstimator a;
+  for (int i = 0; i < 200; i++)
+  {
+    double time = i * 0.02;
+    a.AddMeasurement(time, SimulatedOffset(i, time, 0.040, 0.0));
+  }
+  EXPECT_TRUE(a.IsValid());
+  EXPECT_NEAR(0.040, a.GetOffset(), 0.002);
+  EXPECT_NEAR(0.0, a.GetDrift(), 0.0005);
+  EXPECT_LT(a.GetOffsetDeviation(), 0.002);
+}
+
+TEST(TestDriftEstimator, Drift)
+{
+  // 200ppm drift, 20 seconds of audio packets
+  CDriftEstimator a;
+  double time = 0.0;
+  for (int i = 0; i < 1000; i++)
+  {
+    time = i * 0.02;
+    a.AddMeasurement(time, SimulatedOffset(i, time, -0.010, 0.0002));
+  }
+  EXPECT_NEAR(-0.010 + 0.0002 * time, a.GetOffset(), 0.002);
+  EXPECT_NEAR(0.0002, a.GetDrift(), 0.00005);
+  EXPECT_NEAR(-0.010 + 0.0002 * (time + 10.0), a.GetOffset(time + 10.0), 0.003);
+}
+
+TEST(TestDriftEstimator, Outlier)
+{
+  CDriftEstimator a;
+  for (int i = 0; i < 100; i++)
+    a.AddMeasurement(i * 0.02, SimulatedOffset(i, i * 0.02, 0.0, 0.0));
+
+  a.AddMeasurement(2.0, 0.5);
+  EXPECT_NEAR(0.0, a.GetOffset(), 0.002);
+  EXPECT_EQ(1U, a.GetStats().outliers);
+
+  // a persistent jump is accepted after a few measurements
+  for (int i = 101; i < 200; i++)
+    a.AddMeasurement(i * 0.02, SimulatedOffset(i, i * 0.02, 0.050, 0.0));
+  EXPECT_NEAR(0.050, a.GetOffset(), 0.005);
+}
+
+TEST(TestDriftEstimator, Correct)
+{
+  CDriftEstimator a;
+  for (int i = 0; i < 100; i++)
+    a.AddMeasurement(i * 0.02, SimulatedOffset(i, i * 0.02, 0.030, 0.0));
+
+  a.Correct(-0.030);
+  EXPECT_NEAR(0.0, a.GetOffset(), 0.002);
+
+  a.Reset();
+  EXPECT_FALSE(a.IsValid());
+  EXPECT_EQ(0U, a.GetStats().measurements);
+}
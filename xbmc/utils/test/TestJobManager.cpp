@@ -88,3 +88,21 @@ TEST_F(TestJobManager, IsProcessing)
 
   CJobManager::GetInstance().CancelJobs();
 }
+
+TEST_F(TestJobManager, JobWaiter)
+{
+  CJobWaiter waiter(2);
+  EXPECT_EQ(2u, waiter.Remaining());
+  EXPECT_FALSE(waiter.Wait(0));
+
+  waiter.OnJobComplete(0, true, NULL);
+  EXPECT_EQ(1u, waiter.Remaining());
+  EXPECT_FALSE(waiter.Wait(0));
+
+  waiter.OnJobComplete(0, true, NULL);
+  EXPECT_EQ(0u, waiter.Remaining());
+  EXPECT_TRUE(waiter.Wait(0));
+
+  CJobWaiter none(0);
+  EXPECT_TRUE(none.Wait(0));
+}
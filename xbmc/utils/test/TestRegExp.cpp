@@ -132,6 +132,49 @@ TEST(TestRegExp, operatorEqual)
   EXPECT_STREQ("string", match.c_str());
 }
 
+TEST(TestRegExp, CompiledPatternOutlivesOriginal)
+{
+  CRegExp *regex = new CRegExp(true);
+  EXPECT_TRUE(regex->RegComp("^test\\s+(\\w+)$"));
+  CRegExp regexcopy(*regex);
+  delete regex;
+
+  /* recompiling the same pattern gets the shared one */
+  CRegExp regex2(true);
+  EXPECT_TRUE(regex2.RegComp("^test\\s+(\\w+)$"));
+
+  EXPECT_EQ(0, regexcopy.RegFind("TEST string"));
+  EXPECT_STREQ("string", regexcopy.GetMatch(1).c_str());
+  EXPECT_EQ(0, regex2.RegFind("Test again"));
+  EXPECT_STREQ("again", regex2.GetMatch(1).c_str());
+
+  /* case sensitive compiles of the same pattern are distinct */
+  CRegExp regex3;
+  EXPECT_TRUE(regex3.RegComp("^test\\s+(\\w+)$"));
+  EXPECT_EQ(-1, regex3.RegFind("TEST string"));
+}
+
+TEST(TestRegExp, RegCompAny)
+{
+  CRegExp regex;
+  std::vector<std::string> patterns;
+  patterns.push_back("s([0-9]+)e([0-9]+)");
+  patterns.push_back("(?<![0-9])([0-9]+)x([0-9]+)");
+  patterns.push_back("p(?:ar)?t[_. -]()([ivx]+)");
+
+  EXPECT_TRUE(regex.RegCompAny(patterns));
+  EXPECT_EQ(5, regex.RegFind("show.s01e02.avi"));
+  EXPECT_EQ(5, regex.RegFind("show.1x02.avi"));
+  EXPECT_EQ(5, regex.RegFind("show.part.iv.avi"));
+  EXPECT_EQ(-1, regex.RegFind("movie.2010.avi"));
+
+  /* backreferences and named groups can't be combined */
+  patterns.push_back("(a)\\1");
+  EXPECT_FALSE(regex.RegCompAny(patterns));
+  patterns.back() = "(?<name>a)";
+  EXPECT_FALSE(regex.RegCompAny(patterns));
+}
+
 class TestRegExpLog : public testing::Test
 {
 protected:
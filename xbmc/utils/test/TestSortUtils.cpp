@@ -115,6 +115,65 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", items.at(6)[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_SpecialAndFolders)
+{
+  SortItems items;
+  const char *labels[] = { "D", "C", "B", "A", "E" };
+  for (int i = 0; i < 5; i++)
+  {
+    SortItem item;
+    item[FieldLabel] = labels[i];
+    item[FieldFolder] = (i == 1 || i == 2);
+    items.push_back(item);
+  }
+  items[0][FieldSortSpecial] = (int)SortSpecialOnBottom;
+  items[4][FieldSortSpecial] = (int)SortSpecialOnTop;
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  EXPECT_STREQ("E", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("A", items.at(3)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("D", items.at(4)[FieldLabel].asString().c_str());
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeIgnoreFolders, items);
+
+  EXPECT_STREQ("E", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("C", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("B", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("A", items.at(3)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("D", items.at(4)[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_ArtistAlbumTrack)
+{
+  SortItems items;
+  const char *artists[] = { "B Artist", "A Artist", "B Artist", "A Artist", "B Artist" };
+  const char *albums[]  = { "Y Album",  "Z Album",  "X Album",  "Z Album",  "X Album" };
+  const int tracks[]    = { 1,          3,          2,          1,          1 };
+  for (int i = 0; i < 5; i++)
+  {
+    SortItem item;
+    item[FieldArtist] = artists[i];
+    item[FieldAlbum] = albums[i];
+    item[FieldTrackNumber] = tracks[i];
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByArtist, SortOrderAscending, SortAttributeNone, items);
+
+  EXPECT_STREQ("A Artist", items.at(0)[FieldArtist].asString().c_str());
+  EXPECT_EQ(1, items.at(0)[FieldTrackNumber].asInteger());
+  EXPECT_STREQ("A Artist", items.at(1)[FieldArtist].asString().c_str());
+  EXPECT_EQ(3, items.at(1)[FieldTrackNumber].asInteger());
+  EXPECT_STREQ("X Album", items.at(2)[FieldAlbum].asString().c_str());
+  EXPECT_EQ(1, items.at(2)[FieldTrackNumber].asInteger());
+  EXPECT_STREQ("X Album", items.at(3)[FieldAlbum].asString().c_str());
+  EXPECT_EQ(2, items.at(3)[FieldTrackNumber].asInteger());
+  EXPECT_STREQ("Y Album", items.at(4)[FieldAlbum].asString().c_str());
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
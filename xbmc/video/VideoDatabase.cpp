@@ -46,6 +46,7 @@
 #include "guilib/LocalizeStrings.h"
 #include "utils/TimeUtils.h"
 #include "utils/log.h"
+#include "utils/DirectoryHashTree.h"
 #include "TextureCache.h"
 #include "addons/AddonInstaller.h"
 #include "interfaces/AnnouncementManager.h"
@@ -683,6 +684,32 @@ bool CVideoDatabase::GetPathHash(const CStdString &path, CStdString &hash)
   return false;
 }
 
+bool CVideoDatabase::GetPathHashes(CDirectoryHashTree &tree)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // paths without a hash were never scanned completely, keep them so their parents get listed
+    CStdString strSQL = "select strPath, strHash from path";
+    m_pDS->query(strSQL.c_str());
+    while (!m_pDS->eof())
+    {
+      tree.Add(m_pDS->fv(0).get_asString(), m_pDS->fv(1).get_asString());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+
+  return false;
+}
+
 //********************************************************************************************************************************
 int CVideoDatabase::AddFile(const CStdString& strFileNameAndPath)
 {
@@ -3697,6 +3724,43 @@ string CVideoDatabase::GetArtForItem(int mediaId, const string &mediaType, const
   return GetSingleValue(query, m_pDS2);
 }
 
+bool CVideoDatabase::GetArtForItems(const vector<int> &mediaIds, const string &mediaType, map<int, map<string, string> > &art)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS2.get()) return false; // using dataset 2 as we're likely called in loops on dataset 1
+
+    // items without art still get an (empty) entry, so callers know they've been looked up
+    static const size_t chunkSize = 500;
+    for (size_t start = 0; start < mediaIds.size(); start += chunkSize)
+    {
+      CStdString ids;
+      for (size_t i = start; i < mediaIds.size() && i < start + chunkSize; i++)
+      {
+        ids.AppendFormat("%i,", mediaIds[i]);
+        art[mediaIds[i]];
+      }
+      ids.TrimRight(",");
+
+      CStdString sql = PrepareSQL("SELECT media_id,type,url FROM art WHERE media_type='%s' AND media_id IN (%s)", mediaType.c_str(), ids.c_str());
+      m_pDS2->query(sql.c_str());
+      while (!m_pDS2->eof())
+      {
+        art[m_pDS2->fv(0).get_asInt()].insert(make_pair(m_pDS2->fv(1).get_asString(), m_pDS2->fv(2).get_asString()));
+        m_pDS2->next();
+      }
+      m_pDS2->close();
+    }
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%s) failed", __FUNCTION__, mediaType.c_str());
+  }
+  return false;
+}
+
 bool CVideoDatabase::GetTvShowSeasonArt(int showId, map<int, map<string, string> > &seasonArt)
 {
   try
@@ -8978,7 +9042,12 @@ void CVideoDatabase::InvalidatePathHash(const CStdString& strPath)
 bool CVideoDatabase::CommitTransaction()
 {
   if (CDatabase::CommitTransaction())
-  { // number of items in the db has likely changed, so recalculate
+  {
+    // inside a batch the recalculation is left to CommitBatch()
+    if (InTransaction())
+      return true;
+
+    // number of items in the db has likely changed, so recalculate
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
     g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
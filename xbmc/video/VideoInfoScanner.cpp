@@ -50,6 +50,7 @@
 #include "TextureCache.h"
 #include "GUIUserMessages.h"
 #include "URL.h"
+#include "threads/SingleLock.h"
 
 using namespace std;
 using namespace XFILE;
@@ -58,6 +59,97 @@ using namespace ADDON;
 namespace VIDEO
 {
 
+  /*! \brief Fetches episode details for a list of matched episodes from several threads.
+   The scraper parser keeps the fetched pages as its parameters, so every thread
+   but the first works on its own copy of the scraper. The copies are made before
+   any thread starts, while the scraper isn't in use.
+   */
+  class CEpisodeDetailsFetcher : public IRunnable
+  {
+  public:
+    struct Fetch
+    {
+      EPISODE file;
+      CScraperUrl url;
+      CFileItemPtr item;
+      bool found;
+    };
+
+    CEpisodeDetailsFetcher(vector<Fetch> &fetches, const ScraperPtr &scraper, const volatile bool &stop)
+      : m_fetches(fetches), m_scraper(scraper), m_stop(stop), m_next(0), m_threads(0), m_cancelled(false)
+    {
+    }
+
+    virtual void Run()
+    {
+      ScraperPtr scraper;
+      {
+        CSingleLock lock(m_section);
+        scraper = m_scrapers[m_threads++];
+      }
+
+      CVideoInfoDownloader imdb(scraper);
+      while (!m_stop && !m_cancelled)
+      {
+        Fetch *fetch;
+        {
+          CSingleLock lock(m_section);
+          if (m_next >= m_fetches.size())
+            break;
+          fetch = &m_fetches[m_next++];
+        }
+        fetch->found = imdb.GetEpisodeDetails(fetch->url, *fetch->item->GetVideoInfoTag());
+      }
+    }
+
+    /*! \brief Fetch all episodes using up to <scraperthreads> threads.
+     \param progress progress dialog to update while waiting, may be NULL.
+     \return false if the fetch was cancelled, true otherwise.
+     */
+    bool FetchAll(CGUIDialogProgress *progress)
+    {
+      unsigned int threads = std::min((unsigned int)g_advancedSettings.m_iVideoLibraryScraperThreads, (unsigned int)m_fetches.size());
+
+      m_scrapers.push_back(m_scraper);
+      while (m_scrapers.size() < threads)
+        m_scrapers.push_back(boost::dynamic_pointer_cast<CScraper>(m_scraper->Clone(m_scraper)));
+
+      vector<CThread*> workers;
+      for (unsigned int i = 0; i < threads; i++)
+      {
+        CThread *worker = new CThread(this, "CEpisodeDetailsFetcher");
+        worker->Create();
+        workers.push_back(worker);
+      }
+
+      for (vector<CThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+      {
+        while (!(*it)->WaitForThreadExit(100))
+        {
+          if (progress)
+          {
+            progress->Progress();
+            if (progress->IsCanceled())
+              m_cancelled = true;
+          }
+        }
+        delete *it;
+      }
+
+      return !m_cancelled && !m_stop;
+    }
+
+  private:
+    vector<Fetch> &m_fetches;
+    const ScraperPtr &m_scraper;
+    vector<ScraperPtr> m_scrapers;
+    const volatile bool &m_stop;
+    CCriticalSection m_section;
+    unsigned int m_next;
+    unsigned int m_threads;
+    volatile bool m_cancelled;
+  };
+
   CVideoInfoScanner::CVideoInfoScanner() : CThread("CVideoInfoScanner")
   {
     m_bRunning = false;
@@ -68,6 +160,7 @@ namespace VIDEO
     m_itemCount = 0;
     m_bClean = false;
     m_scanAll = false;
+    CompileEpisodeFilter();
   }
 
   CVideoInfoScanner::~CVideoInfoScanner()
@@ -82,6 +175,10 @@ namespace VIDEO
 
       m_database.Open();
 
+      // directories seen by earlier scans, so that unchanged ones needn't be listed
+      m_pathTree.Clear();
+      m_database.GetPathHashes(m_pathTree);
+
       if (m_showDialog && !g_guiSettings.GetBool("videolibrary.backgroundupdate"))
       {
         CGUIDialogExtendedProgressBar* dialog =
@@ -186,6 +283,7 @@ namespace VIDEO
     m_bClean = g_advancedSettings.m_bVideoLibraryCleanOnUpdate;
 
     StopThread();
+    CompileEpisodeFilter();
     Create();
     m_bRunning = true;
   }
@@ -255,7 +353,7 @@ namespace VIDEO
     if (content == CONTENT_NONE || ignoreFolder)
       return true;
 
-    CStdString hash, dbHash;
+    CStdString hash, dbHash, listHash;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -265,11 +363,18 @@ namespace VIDEO
       }
 
       CStdString fastHash = GetFastHash(strDirectory);
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash)
-      { // fast hashes match - no need to process anything
+      vector<string> subdirs;
+      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.IsEmpty() && fastHash == dbHash &&
+          m_pathTree.GetSubDirectories(strDirectory, "fast", subdirs))
+      { // fast hashes match - no need to process anything but the subfolders we know of
         CLog::Log(LOGDEBUG, "VideoInfoScanner: Skipping dir '%s' due to no change (fasthash)", strDirectory.c_str());
         hash = fastHash;
         bSkip = true;
+        for (vector<string>::const_iterator it = subdirs.begin(); it != subdirs.end(); ++it)
+        {
+          CFileItemPtr item(new CFileItem(*it, true));
+          items.Add(item);
+        }
       }
       if (!bSkip)
       { // need to fetch the folder
@@ -298,7 +403,8 @@ namespace VIDEO
             OnDirectoryScanned(strDirectory);
         }
         // update the hash to a fast hash if needed
-        if (CanFastHash(items) && !fastHash.IsEmpty())
+        listHash = hash;
+        if (!fastHash.IsEmpty())
           hash = fastHash;
       }
     }
@@ -373,9 +479,43 @@ namespace VIDEO
         }
       }
     }
+
+    // with a fast hash the next scan only descends into the subfolders stored in the database.
+    // Subfolders that were excluded, set to no update or failed to scan have no fast hash, so
+    // fall back to a full hash that makes the next scan list this folder and find them again.
+    if ((content == CONTENT_MOVIES || content == CONTENT_MUSICVIDEOS) && settings.recurse > 0 &&
+        m_database.GetPathHash(strDirectory, dbHash) && StringUtils::StartsWith(dbHash, "fast") &&
+        !HasFastHashedSubFolders(items))
+    {
+      if (listHash.IsEmpty())
+      { // the folder was skipped on its fast hash without being listed
+        CFileItemList listing;
+        CDirectory::GetDirectory(strDirectory, listing, g_settings.m_videoExtensions);
+        listing.Stack();
+        GetPathHash(listing, listHash);
+      }
+      // an empty hash (folder not retrievable) has the next scan treat the folder as new, which also finds them
+      CLog::Log(LOGDEBUG, "VideoInfoScanner: Not fast hashing dir '%s' as not all its subfolders are", strDirectory.c_str());
+      m_database.SetPathHash(strDirectory, listHash);
+    }
     return !m_bStop;
   }
 
+  bool CVideoInfoScanner::HasFastHashedSubFolders(const CFileItemList &items)
+  {
+    for (int i = 0; i < items.Size(); ++i)
+    {
+      CFileItemPtr pItem = items[i];
+      if (!pItem->m_bIsFolder || pItem->IsParentFolder() || pItem->IsPlayList())
+        continue;
+
+      CStdString hash;
+      if (!m_database.GetPathHash(pItem->GetPath(), hash) || !StringUtils::StartsWith(hash, "fast"))
+        return false;
+    }
+    return true;
+  }
+
   bool CVideoInfoScanner::RetrieveVideoInfo(CFileItemList& items, bool bDirNames, CONTENT_TYPE content, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress)
   {
     if (pDlgProgress)
@@ -657,6 +797,7 @@ namespace VIDEO
 
     CVideoInfoTag showInfo;
     m_database.GetTvShowInfo("", showInfo, showID);
+
     return OnProcessSeriesFolder(files, scraper, useLocal, showInfo, progress);
   }
 
@@ -861,15 +1002,29 @@ namespace VIDEO
     return false;
   }
 
+  void CVideoInfoScanner::CompileEpisodeFilter()
+  {
+    const SETTINGS_TVSHOWLIST &expression = g_advancedSettings.m_tvshowEnumRegExps;
+
+    std::vector<std::string> patterns;
+    for (SETTINGS_TVSHOWLIST::const_iterator it = expression.begin(); it != expression.end(); ++it)
+      patterns.push_back(it->regexp);
+    m_hasEpisodeFilter = m_episodeFilter.RegCompAny(patterns) != NULL;
+  }
+
   bool CVideoInfoScanner::EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList)
   {
-    SETTINGS_TVSHOWLIST expression = g_advancedSettings.m_tvshowEnumRegExps;
+    const SETTINGS_TVSHOWLIST &expression = g_advancedSettings.m_tvshowEnumRegExps;
 
     CStdString strLabel=item->GetPath();
     // URLDecode in case an episode is on a http/https/dav/davs:// source and URL-encoded like foo%201x01%20bar.avi
     CURL::Decode(strLabel);
     strLabel.MakeLower();
 
+    // test all expressions in a single pass first, so files matching none of them are rejected quickly
+    if (m_hasEpisodeFilter && m_episodeFilter.RegFind(strLabel.c_str()) < 0)
+      return false;
+
     for (unsigned int i=0;i<expression.size();++i)
     {
       CRegExp reg;
@@ -1314,6 +1469,8 @@ namespace VIDEO
 
     EPISODELIST episodes;
     bool hasEpisodeGuide = false;
+    vector<CEpisodeDetailsFetcher::Fetch> fetches;
+    vector<CEpisodeDetailsFetcher::Fetch> added; // episodes to write once all details are there
 
     int iMax = files.size();
     int iCurr = 1;
@@ -1355,8 +1512,11 @@ namespace VIDEO
         // override with episode and season number
         item.GetVideoInfoTag()->m_iEpisode = file->iEpisode;
         item.GetVideoInfoTag()->m_iSeason = file->iSeason;
-        if (AddVideo(&item, CONTENT_TVSHOWS, file->isFolder, true, &showInfo) < 0)
-          return INFO_ERROR;
+        CEpisodeDetailsFetcher::Fetch local;
+        local.file = *file;
+        local.item.reset(new CFileItem(item));
+        local.found = true;
+        added.push_back(local);
         continue;
       }
 
@@ -1460,20 +1620,15 @@ namespace VIDEO
 
       if (bFound)
       {
-        CVideoInfoDownloader imdb(scraper);
-        CFileItem item;
-        item.SetPath(file->strPath);
-        if (!imdb.GetEpisodeDetails(guide->cScraperUrl, *item.GetVideoInfoTag(), pDlgProgress))
-          return INFO_NOT_FOUND; // TODO: should we just skip to the next episode?
-          
-        // Only set season/epnum from filename when it is not already set by a scraper
-        if (item.GetVideoInfoTag()->m_iSeason == -1)
-          item.GetVideoInfoTag()->m_iSeason = guide->iSeason;
-        if (item.GetVideoInfoTag()->m_iEpisode == -1)
-          item.GetVideoInfoTag()->m_iEpisode = guide->iEpisode;
-          
-        if (AddVideo(&item, CONTENT_TVSHOWS, file->isFolder, useLocal, &showInfo) < 0)
-          return INFO_ERROR;
+        // the details are fetched for all matched episodes at once below
+        CEpisodeDetailsFetcher::Fetch fetch;
+        fetch.file = *file;
+        fetch.file.iSeason = guide->iSeason;
+        fetch.file.iEpisode = guide->iEpisode;
+        fetch.url = guide->cScraperUrl;
+        fetch.item.reset(new CFileItem(file->strPath, false));
+        fetch.found = false;
+        fetches.push_back(fetch);
       }
       else
       {
@@ -1482,7 +1637,59 @@ namespace VIDEO
                   file->cDate.GetAsLocalizedDate().c_str(), file->strTitle.c_str());
       }
     }
-    return INFO_ADDED;
+
+    if (!fetches.empty())
+    {
+      if (pDlgProgress)
+      {
+        pDlgProgress->SetLine(2, 20465);
+        pDlgProgress->Progress();
+      }
+      CEpisodeDetailsFetcher fetcher(fetches, scraper, m_bStop);
+      if (!fetcher.FetchAll(pDlgProgress))
+        return INFO_CANCELLED;
+    }
+
+    INFO_RET ret = INFO_ADDED;
+    for (vector<CEpisodeDetailsFetcher::Fetch>::iterator fetch = fetches.begin(); fetch != fetches.end(); ++fetch)
+    {
+      if (!fetch->found)
+      {
+        ret = INFO_NOT_FOUND;
+        continue;
+      }
+
+      // Only set season/epnum from filename when it is not already set by a scraper
+      CVideoInfoTag *tag = fetch->item->GetVideoInfoTag();
+      if (tag->m_iSeason == -1)
+        tag->m_iSeason = fetch->file.iSeason;
+      if (tag->m_iEpisode == -1)
+        tag->m_iEpisode = fetch->file.iEpisode;
+
+      added.push_back(*fetch);
+    }
+
+    // write all the episodes of the show in one go, now that nothing is left to download.
+    // A write that was rolled back discards the whole batch, so then add them one at a time
+    for (int batch = 1; batch >= 0 && !added.empty(); batch--)
+    {
+      if (batch)
+        m_database.BeginBatch();
+
+      bool failed = false;
+      for (vector<CEpisodeDetailsFetcher::Fetch>::iterator episode = added.begin(); episode != added.end() && !failed; ++episode)
+        failed = AddVideo(episode->item.get(), CONTENT_TVSHOWS, episode->file.isFolder, useLocal, &showInfo) < 0;
+
+      if (batch && !m_database.CommitBatch())
+      {
+        CLog::Log(LOGWARNING, "%s - storing the episodes of %s failed, storing them one at a time", __FUNCTION__, showInfo.m_strTitle.c_str());
+        continue;
+      }
+      if (failed)
+        return INFO_ERROR;
+      break;
+    }
+    return ret;
   }
 
   CStdString CVideoInfoScanner::GetnfoFile(CFileItem *item, bool bGrabAny) const
@@ -1658,16 +1865,6 @@ namespace VIDEO
     return count;
   }
 
-  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items) const
-  {
-    // TODO: Probably should account for excluded folders here (eg samples), though that then
-    //       introduces possible problems if the user then changes the exclude regexps and
-    //       expects excluded folders that are inside a fast-hashed folder to then be picked
-    //       up. The chances that the user has a folder which contains only excluded folders
-    //       where some of those folders should be scanned recursively is pretty small.
-    return items.GetFolderCount() == 0;
-  }
-
   CStdString CVideoInfoScanner::GetFastHash(const CStdString &directory) const
   {
     struct __stat64 buffer;
@@ -22,6 +22,8 @@
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
 #include "NfoFile.h"
+#include "utils/DirectoryHashTree.h"
+#include "utils/RegExp.h"
 
 class CRegExp;
 class CFileItem;
@@ -190,14 +192,12 @@ namespace VIDEO
      */
     CStdString GetFastHash(const CStdString &directory) const;
 
-    /*! \brief Decide whether a folder listing could use the "fast" hash
-     Fast hashing can be done whenever the folder contains no scannable subfolders, as the
-     fast hash technique uses modified time to determine when folder content changes, which
-     is generally not propogated up the directory tree.
-     \param items the directory listing
-     \return true if this directory listing can be fast hashed, false otherwise
+    /*! \brief Check whether all subfolders in a listing are stored with a fast hash
+     \param items the listing of a folder
+     \return true if every subfolder has a fast hash in the database
+     \sa GetFastHash
      */
-    bool CanFastHash(const CFileItemList &items) const;
+    bool HasFastHashedSubFolders(const CFileItemList &items);
 
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      TODO: Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
@@ -212,6 +212,12 @@ namespace VIDEO
      */
     INFO_RET OnProcessSeriesFolder(EPISODELIST& files, const ADDON::ScraperPtr &scraper, bool useLocal, const CVideoInfoTag& showInfo, CGUIDialogProgress* pDlgProgress = NULL);
 
+    /*! \brief Combine the tv show enumeration expressions into a single pattern.
+     Done once per scan, so that files matching none of the expressions are rejected in one pass.
+     \sa EnumerateEpisodeItem
+     */
+    void CompileEpisodeFilter();
+
     void EnumerateSeriesFolder(CFileItem* item, EPISODELIST& episodeList);
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
     bool ProcessItemByVideoInfoTag(const CFileItem *item, EPISODELIST &episodeList);
@@ -238,6 +244,9 @@ namespace VIDEO
     std::set<CStdString> m_pathsToCount;
     std::set<int> m_pathsToClean;
     CNfoFile m_nfoReader;
+    CDirectoryHashTree m_pathTree;
+    CRegExp m_episodeFilter;
+    bool m_hasEpisodeFilter;
   };
 }
 
@@ -26,10 +26,12 @@
 #include "filesystem/DirectoryCache.h"
 #include "FileItem.h"
 #include "settings/GUISettings.h"
+#include "settings/AdvancedSettings.h"
 #include "GUIUserMessages.h"
 #include "guilib/GUIWindowManager.h"
 #include "TextureCache.h"
 #include "utils/log.h"
+#include "utils/CPUInfo.h"
 #include "video/VideoInfoTag.h"
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
@@ -111,7 +113,7 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(1), CJobQueue(true), m_pStreamDetailsObs(NULL)
+  CThumbLoader(1), CJobQueue(true, GetExtractionJobs()), m_pStreamDetailsObs(NULL)
 {
   m_database = new CVideoDatabase();
 }
@@ -122,6 +124,15 @@ CVideoThumbLoader::~CVideoThumbLoader()
   delete m_database;
 }
 
+unsigned int CVideoThumbLoader::GetExtractionJobs()
+{
+  // thumb and stream details extraction is mostly decode and I/O bound per
+  // file, so run one extraction per cpu unless overridden
+  if (g_advancedSettings.m_videoThumbExtractionJobs > 0)
+    return g_advancedSettings.m_videoThumbExtractionJobs;
+  return std::max(1, g_cpuInfo.getCPUCount());
+}
+
 void CVideoThumbLoader::Initialize()
 {
   m_database->Open();
@@ -131,12 +142,67 @@ void CVideoThumbLoader::Initialize()
 void CVideoThumbLoader::OnLoaderStart()
 {
   Initialize();
+  FetchLibraryArt();
 }
 
 void CVideoThumbLoader::OnLoaderFinish()
 {
   m_database->Close();
   m_showArt.clear();
+  m_libraryArt.clear();
+}
+
+void CVideoThumbLoader::FetchLibraryArt()
+{
+  m_libraryArt.clear();
+
+  // collect the items that will end up in FillLibraryArt()
+  map<string, vector<int> > ids;
+  vector<int> showIds;
+  for (vector<CFileItemPtr>::const_iterator i = m_vecItems.begin(); i != m_vecItems.end(); ++i)
+  {
+    const CFileItemPtr &item = *i;
+    if (!item->HasVideoInfoTag() || item->HasArt("thumb"))
+      continue;
+    const CVideoInfoTag *tag = item->GetVideoInfoTag();
+    if (tag->m_iDbId > -1 && !tag->m_type.IsEmpty())
+    {
+      ids[tag->m_type].push_back(tag->m_iDbId);
+      if (tag->m_iIdShow >= 0 && m_showArt.find(tag->m_iIdShow) == m_showArt.end())
+      {
+        m_showArt[tag->m_iIdShow];
+        showIds.push_back(tag->m_iIdShow);
+      }
+    }
+  }
+  if (ids.empty())
+    return;
+
+  for (map<string, vector<int> >::const_iterator i = ids.begin(); i != ids.end(); ++i)
+  {
+    if (!m_database->GetArtForItems(i->second, i->first, m_libraryArt[i->first]))
+      m_libraryArt.erase(i->first);
+  }
+  if (!showIds.empty() && !m_database->GetArtForItems(showIds, "tvshow", m_showArt))
+  {
+    for (vector<int>::const_iterator i = showIds.begin(); i != showIds.end(); ++i)
+      m_showArt.erase(*i);
+  }
+}
+
+bool CVideoThumbLoader::GetLibraryArt(int dbId, const string &type, map<string, string> &art)
+{
+  map<string, ArtCache>::const_iterator i = m_libraryArt.find(type);
+  if (i != m_libraryArt.end())
+  {
+    ArtCache::const_iterator j = i->second.find(dbId);
+    if (j != i->second.end())
+    {
+      art = j->second;
+      return !art.empty();
+    }
+  }
+  return m_database->GetArtForItem(dbId, type, art);
 }
 
 static void SetupRarOptions(CFileItem& item, const CStdString& path)
@@ -322,7 +388,7 @@ bool CVideoThumbLoader::FillLibraryArt(CFileItem &item)
   {
     map<string, string> artwork;
     m_database->Open();
-    if (m_database->GetArtForItem(tag.m_iDbId, tag.m_type, artwork))
+    if (GetLibraryArt(tag.m_iDbId, tag.m_type, artwork))
       SetArt(item, artwork);
     else if (tag.m_type == "artist")
     { // we retrieve music video art from the music database (no backward compat)
@@ -125,8 +125,24 @@ protected:
   virtual void OnLoaderStart();
   virtual void OnLoaderFinish();
 
+  /*! \brief number of thumb/stream details extraction jobs to run at once
+   \return the <thumbextractionjobs> advanced setting, or the number of cpus if unset.
+   */
+  static unsigned int GetExtractionJobs();
+
+  /*! \brief fetch the library art of all items being loaded with one query per media type
+   \sa GetLibraryArt
+   */
+  void FetchLibraryArt();
+
+  /*! \brief retrieve the art of a library item, from the fetched art if available
+   \sa FetchLibraryArt
+   */
+  bool GetLibraryArt(int dbId, const std::string &type, std::map<std::string, std::string> &art);
+
   IStreamDetailsObserver *m_pStreamDetailsObs;
   CVideoDatabase *m_database;
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
+  std::map<std::string, ArtCache> m_libraryArt; ///< art of the items being loaded, by media type
 };
@@ -2207,6 +2207,11 @@ void CGUIWindowVideoBase::OnAssignContent(const CStdString &path)
   }
 }
 
+void CGUIWindowVideoBase::OnSelectionChanged(const CFileItemPtr &item)
+{
+  m_thumbLoader.PrioritizeItem(item);
+}
+
 void CGUIWindowVideoBase::OnInitWindow()
 {
   CGUIMediaWindow::OnInitWindow();
@@ -88,6 +88,7 @@ protected:
   virtual bool Update(const CStdString &strDirectory, bool updateFilterPath = true);
   virtual bool GetDirectory(const CStdString &strDirectory, CFileItemList &items);
   virtual void OnItemLoaded(CFileItem* pItem) {};
+  virtual void OnSelectionChanged(const CFileItemPtr &item);
   virtual void GetGroupedItems(CFileItemList &items);
 
   virtual bool CheckFilterAdvanced(CFileItemList &items) const;
@@ -1497,6 +1497,18 @@ void CGUIMediaWindow::OnRenameItem(int iItem)
   m_viewControl.SetSelectedItem(iItem);
 }
 
+void CGUIMediaWindow::FrameMove()
+{
+  CFileItemPtr item = m_vecItems->Get(m_viewControl.GetSelectedItem());
+  if (item != m_lastSelectedItem)
+  {
+    m_lastSelectedItem = item;
+    if (item)
+      OnSelectionChanged(item);
+  }
+  CGUIWindow::FrameMove();
+}
+
 void CGUIMediaWindow::OnInitWindow()
 {
   // initial fetch is done unthreaded to ensure the items are setup prior to skin animations kicking off
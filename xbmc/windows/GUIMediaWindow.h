@@ -41,6 +41,7 @@ public:
   virtual void OnWindowLoaded();
   virtual void OnWindowUnload();
   virtual void OnInitWindow();
+  virtual void FrameMove();
   virtual bool IsMediaWindow() const { return true; };
   const CFileItemList &CurrentDirectory() const;
   int GetViewContainerID() const { return m_viewControl.GetCurrentControl(); };
@@ -64,6 +65,11 @@ protected:
    */
   virtual bool OnSelect(int item);
   virtual bool OnPopupMenu(int iItem);
+  /*! \brief Called when a different item got selected in the view.
+   Used to have the background loaders load the items on screen first.
+   \param item the selected item.
+   */
+  virtual void OnSelectionChanged(const CFileItemPtr &item) {};
   virtual void GetContextButtons(int itemNumber, CContextButtons &buttons);
   virtual bool OnContextButton(int itemNumber, CONTEXT_BUTTON button);
   virtual void FormatItemLabels(CFileItemList &items, const LABEL_MASKS &labelMasks);
@@ -167,6 +173,7 @@ protected:
   // save control state on window exit
   int m_iLastControl;
   int m_iSelectedItem;
+  CFileItemPtr m_lastSelectedItem; ///< \brief item that was selected in the last frame
   CStdString m_startDirectory;
 
   CSmartPlaylist m_filter;